@@ -1,12 +1,61 @@
 #pragma once
 #include "CppLuaInterface.h"
 #include "DataTypes.h"
+#include "DirectArrayAccess.h"
 #include <complex>
 #include <vector>
 #include <map>
 #include <functional>
+#include <string_view>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
 namespace LuaStrap {
+	// Finds the members of an aggregate by name - a perfect hash of the member names, built once per 'Traits<T>::members'
+	// (at runtime, since 'members' isn't a constant expression). Duplicate names resolve to the first such member.
+	struct MemberNameIndex {
+		std::vector<std::string_view> names;	// by member index
+		std::vector<int> slots;					// member index by hash slot, -1 = none; the size is a power of 2
+		std::uint32_t seed = 0;
+
+		explicit MemberNameIndex(std::vector<std::string_view> names);
+		auto find(std::string_view name) const -> int {		// the member index, -1 if there's no such member
+			auto memberIdx = slots[hash(name, seed) & (slots.size() - 1)];
+			return memberIdx != -1 && names[memberIdx] == name ? memberIdx : -1;
+		}
+		static auto hash(std::string_view name, std::uint32_t seed) -> std::uint32_t {
+			auto h = 2166136261u ^ (seed * 0x9E3779B9u);	// FNV-1a
+			for (auto c : name) {
+				h = (h ^ std::uint8_t(c)) * 16777619u;
+			}
+			return h ^ (h >> 15);
+		}
+	};
+	template <typename MemMap>
+	auto memberNameIndex(const MemMap& members) -> MemberNameIndex {
+		return std::apply([](const auto&... member) {
+			return MemberNameIndex{ { std::string_view{ member.first }... } };
+		}, members);
+	}
+
+	template <typename T, typename MemMap, size_t index>
+	auto aggregateReadMember(lua_State* ls, T& dest, const MemMap& members) -> bool {	// [-0, +0, m], -1 = the member's value
+		const auto& memberPtr = get<index>(members).second;
+		if constexpr (std::is_member_function_pointer_v<std::remove_cvref_t<decltype(memberPtr)>>) {
+			return true;
+		}
+		else {
+			auto val = LuaStrap::readNoPush<std::decay_t<decltype(std::invoke(memberPtr, dest))>>(ls, -1);
+			if (!val) {
+				return false;
+			}
+			std::invoke(memberPtr, dest) = std::move(*val);
+			return true;
+		}
+	}
+	// Each of the members is looked up in the table by name. Members missing from the table are read from nil
+	// (e.g. optional members may be missing). The members are accessed raw.
 	template <typename T, typename MemMap>
 	auto aggregateRead(lua_State* ls, int idx, MemMap members) -> std::optional<T> {	// [-0, +0, m]
 		idx = lua_absindex(ls, idx);
@@ -16,73 +65,207 @@ namespace LuaStrap {
 		}
 		auto res = std::optional<T>{ T{} };
 
-		auto readMember = [&]<int index> {
-			if constexpr (!std::is_member_function_pointer_v<std::tuple_element_t<1, std::tuple_element_t<index, MemMap>>>)
-			{
-				lua_checkstack(ls, 2);
-				const auto& [memberName, memberPtr] = get<index>(members);
-				LuaStrap::write(ls, memberName);
-				lua_gettable(ls, idx);
-				auto val = LuaStrap::readNoPush<std::decay_t<decltype(std::invoke(memberPtr, *res))>>(ls, -1);
+		lua_checkstack(ls, 1);
+		auto readMember = [&]<size_t index>() {
+			if constexpr (std::is_member_function_pointer_v<std::tuple_element_t<1, std::tuple_element_t<index, MemMap>>>) {
+				return true;
+			}
+			else {
+				lua_pushstring(ls, get<index>(members).first);
+				lua_rawget(ls, idx);
+				auto didRead = aggregateReadMember<T, MemMap, index>(ls, *res, members);
 				lua_pop(ls, 1);
-				if (!val) {
-					return false;
-				}
-				std::invoke(memberPtr, *res) = std::move(*val);
+				return didRead;
 			}
-			return true;
 		};
+		auto didReadAll = [&]<size_t... indices>(std::index_sequence<indices...>) {
+			return (readMember.template operator()<indices>() && ...);
+		}(std::make_index_sequence<std::tuple_size_v<MemMap>>{});
+
+		return didReadAll ? res : std::nullopt;
+	}
+	// Like 'aggregateRead', but the table is traversed once, each of its string keys dispatched to the member of that name
+	// by 'nameIndex' (which must have been made from 'members', see 'memberNameIndex')
+	template <typename T, typename MemMap>
+	auto aggregateReadIndexed(lua_State* ls, int idx, const MemMap& members, const MemberNameIndex& nameIndex) -> std::optional<T> {	// [-0, +0, m]
+		idx = lua_absindex(ls, idx);
 
-		auto readAllMembers = [&] <int... indices>(std::integer_sequence<int, indices...>) -> std::optional<T> {
-			if ((readMember.operator()<indices>() && ...)) {
-				return res;
+		if (lua_type(ls, idx) != LUA_TTABLE) {
+			return std::nullopt;
+		}
+		auto res = std::optional<T>{ T{} };
+
+		constexpr auto memberCount = std::tuple_size_v<MemMap>;
+		static constexpr auto memberReaders = [] <size_t... indices>(std::index_sequence<indices...>) {
+			return std::array<bool(*)(lua_State*, T&, const MemMap&), memberCount>{ &aggregateReadMember<T, MemMap, indices>... };
+		}(std::make_index_sequence<memberCount>{});
+		auto isRead = std::array<bool, memberCount>{};
+
+		lua_checkstack(ls, 2);
+		lua_pushnil(ls);
+		while (lua_next(ls, idx)) {
+			// stack: -2 = key, -1 = val
+			if (lua_type(ls, -2) == LUA_TSTRING) {
+				auto len = size_t{};
+				auto* key = lua_tolstring(ls, -2, &len);
+				auto memberIdx = nameIndex.find({ key, len });
+				if (memberIdx != -1) {
+					if (!memberReaders[memberIdx](ls, *res, members)) {
+						lua_pop(ls, 2);
+						return std::nullopt;
+					}
+					isRead[memberIdx] = true;
+				}
 			}
-			else {
-				return std::nullopt;
+			lua_pop(ls, 1);
+		}
+
+		for (size_t i = 0; i < memberCount; ++i) {
+			if (!isRead[i]) {
+				lua_pushnil(ls);
+				auto didRead = memberReaders[i](ls, *res, members);
+				lua_pop(ls, 1);
+				if (!didRead) {
+					return std::nullopt;
+				}
 			}
-		};
+		}
+		return res;
+	}
+	// The stack need (see 'luaStackNeed') of writing a T as a table of its members
+	template <typename T, typename MemMap>
+	constexpr auto aggregateStackNeed() -> int {
+		return [] <size_t... indices>(std::index_sequence<indices...>) {
+			auto memberNeed = [] <size_t index>() {
+				using MemberPtr = std::tuple_element_t<1, std::tuple_element_t<index, MemMap>>;
+				if constexpr (std::is_member_function_pointer_v<MemberPtr>) {
+					return 1;
+				}
+				else {
+					// the member's value is written above its name
+					using Member = std::decay_t<decltype(std::declval<const T&>().*std::declval<MemberPtr>())>;
+					return luaStackNeedAbove(1, luaStackNeed<Member>());
+				}
+			};
+			// the table, with either its metatable or the member names and a member above it
+			return luaStackNeedAbove(1, luaStackNeedAbove(1, maxLuaStackNeed({ 1, memberNeed.template operator()<indices>()... })));
+		}(std::make_index_sequence<std::tuple_size_v<MemMap>>{});
+	}
+	// Whether any data member of an aggregate borrows lua data (see 'borrowsLuaData')
+	template <typename T, typename MemMap>
+	constexpr auto aggregateBorrowsLuaData() -> bool {
+		return [] <size_t... indices>(std::index_sequence<indices...>) {
+			auto memberBorrows = [] <size_t index>() {
+				using MemberPtr = std::tuple_element_t<1, std::tuple_element_t<index, MemMap>>;
+				if constexpr (std::is_member_function_pointer_v<MemberPtr>) {
+					return false;
+				}
+				else {
+					return borrowsLuaData<std::decay_t<decltype(std::declval<const T&>().*std::declval<MemberPtr>())>>();
+				}
+			};
+			return (memberBorrows.template operator()<indices>() || ...);
+		}(std::make_index_sequence<std::tuple_size_v<MemMap>>{});
+	}
 
-		return readAllMembers(std::make_integer_sequence<int, std::tuple_size_v<MemMap>>{});
+	// The member names of 'Traits<T>::members' (see 'AggregateTraits') are interned once per lua_State, as an array
+	// (by member index) stored along with the metatables (see 'fetchMetatable'), so that writing a member doesn't involve
+	// hashing its name
+	template <typename T>
+	struct AggregateMemberNames {};
+	template <typename T>
+	void pushAggregateMemberNames(lua_State* ls) {	// [-0, +1, m]
+		fetchMetatable(ls, typeId<AggregateMemberNames<T>>(), [](lua_State* ls) {
+			const auto& members = LuaStrap::Traits<T>::members;
+			lua_createtable(ls, int(std::tuple_size_v<std::remove_cvref_t<decltype(members)>>), 0);
+			auto memberIdx = 0;
+			std::apply([&](const auto&... member) {
+				((lua_pushstring(ls, member.first), lua_rawseti(ls, -2, ++memberIdx)), ...);
+			}, members);
+		});
 	}
+
+	// Like 'aggregateEmplace', but assumes the caller has reserved the stack need (if it's known). The member names are
+	// taken from the array at 'namesIdx' (see 'pushAggregateMemberNames') if it's given, otherwise they're pushed as strings.
 	template <typename T, typename MemMap>
-	void aggregateEmplace(lua_State* ls, const T& v, int idx, MemMap members) {	// [-0, +0, m]
-		lua_checkstack(ls, 2);
+	void aggregateEmplaceReserved(lua_State* ls, const T& v, int idx, MemMap members, int namesIdx = 0) {	// [-0, +0, m]
+		if constexpr (aggregateStackNeed<T, MemMap>() == 0) {
+			lua_checkstack(ls, 3);
+		}
 		idx = lua_absindex(ls, idx);
 
 		LuaStrap::BakedData::template metatable<T>(ls);
 		lua_setmetatable(ls, idx);
 
-		auto writeMember = [&](const auto& member) {
-			if constexpr (!std::is_member_function_pointer_v<decltype(member.second)>) {
-				LuaStrap::write(ls, member.first);
-				LuaStrap::write(ls, std::invoke(member.second, v));
+		auto writeMember = [&]<size_t index>() {
+			const auto& [memberName, memberPtr] = get<index>(members);
+			if constexpr (!std::is_member_function_pointer_v<std::remove_cvref_t<decltype(memberPtr)>>) {
+				if (namesIdx != 0) {
+					lua_rawgeti(ls, namesIdx, index + 1);
+				}
+				else {
+					lua_pushstring(ls, memberName);
+				}
+				LuaStrap::writeReserved(ls, std::invoke(memberPtr, v));
 				lua_settable(ls, idx);
 			}
 		};
-
-		if constexpr (std::tuple_size_v<MemMap> > 0) {
-			std::apply([&]<typename... Members>(const Members&... members) {
-				int dummy[] = { (writeMember(members), 0)... };
-			}, members);
+		[&]<size_t... indices>(std::index_sequence<indices...>) {
+			(writeMember.template operator()<indices>(), ...);
+		}(std::make_index_sequence<std::tuple_size_v<MemMap>>{});
+	}
+	// Like 'aggregateEmplaceReserved', with the members of 'Traits<T>' (see 'AggregateTraits'), whose names are interned
+	template <typename T>
+	void aggregateEmplaceInterned(lua_State* ls, const T& v, int idx) {	// [-0, +0, m]
+		using MemMap = std::remove_cvref_t<decltype(LuaStrap::Traits<T>::members)>;
+		if constexpr (aggregateStackNeed<T, MemMap>() == 0) {
+			lua_checkstack(ls, 1);
 		}
+		idx = lua_absindex(ls, idx);
+
+		pushAggregateMemberNames<T>(ls);
+		aggregateEmplaceReserved(ls, v, idx, LuaStrap::Traits<T>::members, lua_gettop(ls));
+		lua_pop(ls, 1);
+	}
+	template <typename T, typename MemMap>
+	void aggregateEmplace(lua_State* ls, const T& v, int idx, MemMap members) {	// [-0, +0, m]
+		constexpr auto need = aggregateStackNeed<T, MemMap>();
+		lua_checkstack(ls, need != 0 ? need - 1 : 3);
+		aggregateEmplaceReserved(ls, v, idx, members);
+	}
+	// How many of the members are data members (i.e. how many entries the lua table of an aggregate has)
+	template <typename MemMap>
+	constexpr auto aggregateDataMemberCount() -> int {
+		return [] <size_t... indices>(std::index_sequence<indices...>) {
+			return (int{ !std::is_member_function_pointer_v<std::tuple_element_t<1, std::tuple_element_t<indices, MemMap>>> } + ... + 0);
+		}(std::make_index_sequence<std::tuple_size_v<MemMap>>{});
 	}
 	template <typename T, typename MemMap>
 	void aggregateWrite(lua_State* ls, const T& v, MemMap members) {	// [-0, +1, m]
-		lua_createtable(ls, 0, 0);
+		lua_createtable(ls, 0, aggregateDataMemberCount<MemMap>());
 		aggregateEmplace(ls, v, -1, members);
 	}
 
 	// Meant to be inherited from by a class specifying a memMap
 	template <typename T>
 	struct AggregateTraits {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
 		static auto read(lua_State* ls, int idx) -> std::optional<T> {
-			return LuaStrap::aggregateRead<T>(ls, idx, LuaStrap::Traits<T>::members);
+			static const auto nameIndex = LuaStrap::memberNameIndex(LuaStrap::Traits<T>::members);
+			return LuaStrap::aggregateReadIndexed<T>(ls, idx, LuaStrap::Traits<T>::members, nameIndex);
 		}
 		static void write(lua_State* ls, const T& v) {
-			return LuaStrap::aggregateWrite<T>(ls, v, LuaStrap::Traits<T>::members);
+			lua_createtable(ls, 0, LuaStrap::aggregateDataMemberCount<std::remove_cvref_t<decltype(LuaStrap::Traits<T>::members)>>());
+			return LuaStrap::aggregateEmplaceInterned<T>(ls, v, -1);
 		}
 		static void emplace(lua_State* ls, const T& v, int idx) {
-			return LuaStrap::aggregateEmplace<T>(ls, v, idx, LuaStrap::Traits<T>::members);
+			return LuaStrap::aggregateEmplaceInterned<T>(ls, v, idx);
+		}
+		static constexpr auto luaStackNeed() -> int {
+			return LuaStrap::aggregateStackNeed<T, std::remove_cvref_t<decltype(LuaStrap::Traits<T>::members)>>();
+		}
+		static constexpr auto isBorrowing() -> bool {
+			return LuaStrap::aggregateBorrowsLuaData<T, std::remove_cvref_t<decltype(LuaStrap::Traits<T>::members)>>();
 		}
 	};	
 
@@ -90,79 +273,138 @@ namespace LuaStrap {
 
 	template <std::integral Int>
 	struct Traits<Int> {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TNUMBER);
 		static auto read(lua_State* ls, int idx) {
 			return lua_isinteger(ls, idx) ?
 				std::optional<Int>{ lua_tointeger(ls, idx) } :
 				std::nullopt;
 		}
 		static void write(lua_State* ls, const Int& v) { lua_pushinteger(ls, v); }
+		static constexpr int luaStackNeed = 1;
 	};
 	template <std::floating_point Float>
 	struct Traits<Float> {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TNUMBER) | luaTypeBit(LUA_TSTRING);	// strings convertible to numbers
 		static auto read(lua_State* ls, int idx) {
 			return lua_isnumber(ls, idx) ?
 				std::optional<Float>{ lua_tonumber(ls, idx) } :
 				std::nullopt;
 		}
 		static void write(lua_State* ls, const Float& v) { lua_pushnumber(ls, v); }
+		static constexpr int luaStackNeed = 1;
 	};
 	template <>
 	struct Traits<bool> {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TBOOLEAN);
 		static auto read(lua_State* ls, int idx) {
 			return lua_isboolean(ls, idx) ?
 				std::optional<bool>{ lua_toboolean(ls, idx) } :
 				std::nullopt;
 		}
 		static void write(lua_State* ls, const bool& v) { lua_pushboolean(ls, v); }
+		static constexpr int luaStackNeed = 1;
 	};
 	template <>
 	struct Traits<std::string> {
-		static auto read(lua_State* ls, int idx) {
-			return lua_type(ls, idx) == LUA_TSTRING ?
-				std::optional<std::string>{lua_tostring(ls, idx)} :
-				std::nullopt;
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TSTRING);
+		static auto read(lua_State* ls, int idx) -> std::optional<std::string> {
+			if (lua_type(ls, idx) != LUA_TSTRING) {
+				return std::nullopt;
+			}
+			auto len = size_t{};
+			auto* str = lua_tolstring(ls, idx, &len);
+			return std::string(str, len);
 		}
-		static void write(lua_State* ls, const std::string& v) { lua_pushstring(ls, v.c_str()); }
+		static void write(lua_State* ls, const std::string& v) { lua_pushlstring(ls, v.data(), v.size()); }
+		static constexpr int luaStackNeed = 1;
+	};
+	// Borrows the buffer of the lua string, so it's only valid while the string is reachable from lua
+	// (e.g. for the duration of a bound function call, if it's the type of a parameter)
+	template <>
+	struct Traits<std::string_view> {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TSTRING);
+		static auto read(lua_State* ls, int idx) -> std::optional<std::string_view> {
+			if (lua_type(ls, idx) != LUA_TSTRING) {
+				return std::nullopt;
+			}
+			auto len = size_t{};
+			auto* str = lua_tolstring(ls, idx, &len);
+			return std::string_view(str, len);
+		}
+		static void write(lua_State* ls, const std::string_view& v) { lua_pushlstring(ls, v.data(), v.size()); }
+		static constexpr int luaStackNeed = 1;
+		static constexpr bool isBorrowing = true;
+	};
+	// A lua string as binary data, borrowed like std::string_view
+	template <>
+	struct Traits<std::span<const std::byte>> {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TSTRING);
+		static auto read(lua_State* ls, int idx) -> std::optional<std::span<const std::byte>> {
+			if (lua_type(ls, idx) != LUA_TSTRING) {
+				return std::nullopt;
+			}
+			auto len = size_t{};
+			auto* str = lua_tolstring(ls, idx, &len);
+			return std::span{ reinterpret_cast<const std::byte*>(str), len };
+		}
+		static void write(lua_State* ls, const std::span<const std::byte>& v) {
+			lua_pushlstring(ls, reinterpret_cast<const char*>(v.data()), v.size());
+		}
+		static constexpr int luaStackNeed = 1;
+		static constexpr bool isBorrowing = true;
 	};
 	template <>
 	struct Traits<const char*> {
 		static void write(lua_State* ls, const char* v) { lua_pushstring(ls, v); }
+		static constexpr int luaStackNeed = 1;
 	};
 	template <typename T>
 	struct Traits<std::complex<T>> {
 		// { [1] = real, [2] = imag }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
+		static constexpr LuaArrayShape luaArrayShape = { 2, -1, luaTypeBit(LUA_TNUMBER) | luaTypeBit(LUA_TSTRING) };
 		static auto read(lua_State* ls, int idx) -> std::optional<std::complex<T>> {	// [-0, +0]
 			if (lua_type(ls, idx) != LUA_TTABLE) {
 				return std::nullopt;
 			}
 
 			lua_checkstack(ls, 2);
-			lua_geti(ls, idx, 1);
-			lua_geti(ls, idx, 2);
-			if (!lua_isnumber(ls, -2) || !lua_isnumber(ls, -1)) {
+			lua_rawgeti(ls, idx, 1);
+			lua_rawgeti(ls, idx, 2);
+			auto isRealNum = 0;
+			auto isImagNum = 0;
+			auto r = lua_tonumberx(ls, -2, &isRealNum);
+			auto i = lua_tonumberx(ls, -1, &isImagNum);
+			lua_pop(ls, 2);
+			if (!isRealNum || !isImagNum) {
 				return std::nullopt;
 			}
 
-			auto r = lua_tonumber(ls, -2);
-			auto i = lua_tonumber(ls, -1);
-			lua_pop(ls, 2);
-
-			return std::optional{ std::complex{r, i} };
+			return std::optional{ std::complex<T>{ T(r), T(i) } };
 		}
 		static void emplace(lua_State* ls, const std::complex<T>& v, int idx) {
-			LuaStrap::write(ls, v.real());
+			LuaStrap::writeReserved(ls, v.real());
 			lua_rawseti(ls, idx, 1);
-			LuaStrap::write(ls, v.imag());
+			LuaStrap::writeReserved(ls, v.imag());
 			lua_rawseti(ls, idx, 2);
 		}
+		static auto tableSize(const std::complex<T>&) -> LuaTableSize { return { 2, 0 }; }
+		static constexpr int luaStackNeed = luaStackNeedAbove(1, LuaStrap::luaStackNeed<T>());
 	};
 
 	template <typename Val, size_t size>
 	struct Traits<std::array<Val, size>> {
 		// { [1] = val1, ... }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
+		static constexpr LuaArrayShape luaArrayShape = { int(size), int(size), acceptedLuaTypes<Val>() };
 		static auto read(lua_State* ls, int idx) -> std::optional<std::array<Val, size>> {	// [-0, +0]		
 			auto origTop = lua_gettop(ls);
 			auto result = std::optional<std::array<Val, size>>{ std::in_place };
+			if constexpr (isDirectlyReadable<Val>()) {
+				if (readArrayDirect(ls, idx, int(size), result->data())) {
+					return result;
+				}
+			}
 			auto didSucceed = (readArrayUpTo<Val>(ls, idx, size, result->begin()) == size);
 			assert(lua_gettop(ls) == origTop);
 
@@ -174,19 +416,42 @@ namespace LuaStrap {
 			}
 		}
 		static void emplace(lua_State* ls, const std::array<Val, size>& v, int idx) {
+			if constexpr (isDirectlyWritable<Val>()) {
+				if (writeArrayDirect(ls, idx, v.data(), int(size))) {
+					return;
+				}
+			}
 			for (std::size_t i = 0; i < v.size(); ++i) {
-				LuaStrap::write(ls, v[i]);
+				LuaStrap::writeReserved(ls, v[i]);
 				lua_rawseti(ls, idx, i + 1);
 			}
 		}
+		static auto tableSize(const std::array<Val, size>&) -> LuaTableSize { return { int(size), 0 }; }
+		static constexpr int luaStackNeed = luaStackNeedAbove(1, LuaStrap::luaStackNeed<Val>());
+		static constexpr bool isBorrowing = LuaStrap::borrowsLuaData<Val>();
 	};
 	template <typename Val>
 	struct Traits<std::vector<Val>> {
 		// { [1] = val1, ... }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
+		static constexpr LuaArrayShape luaArrayShape = { 0, -1, acceptedLuaTypes<Val>() };
 		static auto read(lua_State* ls, int idx) -> std::optional<std::vector<Val>> {	// [-0, +0]
+			if (lua_type(ls, idx) != LUA_TTABLE) {
+				return std::nullopt;
+			}
+
 			auto origTop = lua_gettop(ls);
+			auto length = int(lua_rawlen(ls, idx));
 			auto result = std::optional<std::vector<Val>>{ std::in_place };
-			auto didSucceed = (readArrayUnlimited<Val>(ls, idx, back_inserter(*result)) != -1);
+			if constexpr (isDirectlyReadable<Val>()) {
+				result->resize(length);
+				if (readArrayDirect(ls, idx, length, result->data())) {
+					return result;
+				}
+				result->clear();
+			}
+			result->reserve(length);
+			auto didSucceed = (readArrayOfLength<Val>(ls, idx, length, outputItToSinkFunc<Val>(back_inserter(*result))) != -1);
 			assert(lua_gettop(ls) == origTop);
 
 			if (didSucceed) {
@@ -197,15 +462,35 @@ namespace LuaStrap {
 			}
 		}
 		static void emplace(lua_State* ls, const std::vector<Val>& v, int idx) {
+			if constexpr (isDirectlyWritable<Val>()) {
+				if (writeArrayDirect(ls, idx, v.data(), int(v.size()))) {
+					return;
+				}
+			}
+
+			// Without a metatable (e.g. for a new table) there are no metamethods to respect
+			auto hasMetatable = lua_getmetatable(ls, idx);
+			if (hasMetatable) {
+				lua_pop(ls, 1);
+			}
 			for (std::size_t i = 0; i < v.size(); ++i) {
-				LuaStrap::write(ls, v[i]);
-				lua_seti(ls, idx, i + 1);
+				LuaStrap::writeReserved(ls, v[i]);
+				if (hasMetatable) {
+					lua_seti(ls, idx, i + 1);
+				}
+				else {
+					lua_rawseti(ls, idx, i + 1);
+				}
 			}
 		}
+		static auto tableSize(const std::vector<Val>& v) -> LuaTableSize { return { int(v.size()), 0 }; }
+		static constexpr int luaStackNeed = luaStackNeedAbove(1, LuaStrap::luaStackNeed<Val>());
+		static constexpr bool isBorrowing = LuaStrap::borrowsLuaData<Val>();
 	};
 	template <typename Key, typename Val>
 	struct Traits<std::map<Key, Val>> {
 		// { [key1] = val1, ... }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
 		static auto read(lua_State* ls, int idx) -> std::optional<std::map<Key, Val>> {	// [-0, +0]
 			if (lua_type(ls, idx) != LUA_TTABLE) {
 				return std::nullopt;
@@ -235,15 +520,19 @@ namespace LuaStrap {
 		static void emplace(lua_State* ls, const std::map<Key, Val>& v, int absIdx) {
 			clearTable(ls, absIdx);
 			for (const auto& [key, val] : v) {
-				LuaStrap::write(ls, key);
-				LuaStrap::write(ls, val);
+				LuaStrap::writeReserved(ls, key);
+				LuaStrap::writeReserved(ls, val);
 				lua_settable(ls, absIdx);
 			}
 		}
+		static auto tableSize(const std::map<Key, Val>& v) -> LuaTableSize { return { 0, int(v.size()) }; }
+		static constexpr int luaStackNeed = luaStackNeedAbove(1, maxLuaStackNeed({ LuaStrap::luaStackNeed<Key>(), luaStackNeedAbove(1, LuaStrap::luaStackNeed<Val>()) }));
+		static constexpr bool isBorrowing = LuaStrap::borrowsLuaData<Key>() || LuaStrap::borrowsLuaData<Val>();
 	};
 	template <typename Val>
 	struct Traits<std::optional<Val>> {
 		// Val or nil
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TNIL) | luaTypeBit(LUA_TNONE) | acceptedLuaTypes<Val>();
 		static auto read(lua_State* ls, int idx) {		// [-0, +0]
 			using Ret = std::optional<std::optional<Val>>;			
 
@@ -273,21 +562,33 @@ namespace LuaStrap {
 		}
 		static void write(lua_State* ls, const std::optional<Val>& v) {
 			if (v) {
-				LuaStrap::write(ls, v);
+				LuaStrap::writeReserved(ls, *v);
 			}
 			else {
 				lua_pushnil(ls);
 			}
 		}
+		static constexpr int luaStackNeed = LuaStrap::luaStackNeed<Val>();
+		static constexpr bool isBorrowing = LuaStrap::borrowsLuaData<Val>();
 		static auto defaultValue(lua_State* ls) -> std::optional<Val> {
 			return std::nullopt;
 		}
 	};
 	template <typename... Alts>
 	struct Traits<std::variant<Alts...>> {
+		// Alternatives are attempted in order, but only those whose declared shape fits the lua value (see LuaValueShape).
+		// A keyed table (e.g. { a = 1 }) is read as an array alternative only if no other alternative can take it.
+		static constexpr LuaTypeMask luaTypes = (acceptedLuaTypes<Alts>() | ...);
 		static auto read(lua_State* ls, int idx) -> std::optional<std::variant<Alts...>> {	// [-0, +0]
+			constexpr auto doesAnyCheckElems = ((luaArrayShape<Alts>().elemTypes != anyLuaType) || ...);
+			constexpr auto areArraysMixedWithOthers = (luaArrayShape<Alts>().isArray || ...) && (!luaArrayShape<Alts>().isArray || ...);
+			auto shape = LuaValueShape::probe(ls, idx, doesAnyCheckElems, areArraysMixedWithOthers);
+
 			auto res = std::optional<std::variant<Alts...>>{};
-			auto readAlternative = [&]<typename Alt> {
+			auto readAlternative = [&]<typename Alt>(bool isKeyedArrayPass) {
+				if (!shape.template fits<Alt>() || (shape.isKeyed && luaArrayShape<Alt>().isArray) != isKeyedArrayPass) {
+					return false;
+				}
 				auto val = LuaStrap::readNoPush<Alt>(ls, idx);
 				if (val) {
 					res = val;
@@ -298,7 +599,9 @@ namespace LuaStrap {
 				}
 			};
 
-			auto dummy = (readAlternative.operator()<Alts>() || ...);
+			auto dummy =
+				(readAlternative.template operator()<Alts>(false) || ...) ||
+				(readAlternative.template operator()<Alts>(true) || ...);
 			return res;
 		}
 		static void emplace(lua_State* ls, const std::variant<Alts...>& v, int idx) requires
@@ -310,18 +613,22 @@ namespace LuaStrap {
 		}
 		static void write(lua_State* ls, const std::variant<Alts...>& v) {
 			visit([&]<typename Alt>(const Alt& alternative) {
-				LuaStrap::write(ls, alternative);
+				LuaStrap::writeReserved(ls, alternative);
 			}, v);
 		}
+		static constexpr int luaStackNeed = maxLuaStackNeed({ LuaStrap::luaStackNeed<Alts>()... });
+		static constexpr bool isBorrowing = (LuaStrap::borrowsLuaData<Alts>() || ...);
 	};
 	template <typename... Vals>
 	struct Traits<std::tuple<Vals...>> {
 		// { [1] = val1, ... }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
 		static auto read(lua_State* ls, int idx) -> std::optional<std::tuple<Vals...>> {	// [-0, +0]
 			if (lua_type(ls, idx) != LUA_TTABLE) {
 				return std::nullopt;
 			}
 
+			lua_checkstack(ls, 1);
 			std::tuple<Vals...> res;
 
 			auto readElem = [&]<lua_Integer i>() {
@@ -344,7 +651,7 @@ namespace LuaStrap {
 		}
 		static void emplace(lua_State* ls, const std::tuple<Vals...>& v, int idx) {
 			auto writeElem = [&]<lua_Integer i>() {
-				LuaStrap::write(ls, get<i>(v));
+				LuaStrap::writeReserved(ls, get<i>(v));
 				lua_seti(ls, idx, i + 1);
 				return 0;
 			};
@@ -353,15 +660,20 @@ namespace LuaStrap {
 			};
 			writeAll(std::make_integer_sequence<int, sizeof...(Vals)>{});
 		}
+		static auto tableSize(const std::tuple<Vals...>&) -> LuaTableSize { return { int(sizeof...(Vals)), 0 }; }
+		static constexpr int luaStackNeed = luaStackNeedAbove(1, maxLuaStackNeed({ 1, LuaStrap::luaStackNeed<Vals>()... }));
+		static constexpr bool isBorrowing = (LuaStrap::borrowsLuaData<Vals>() || ...);
 	};
 	template <typename First, typename Second>
 	struct Traits<std::pair<First, Second>> {
 		// { [1] = val1, [2] = val2 }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
 		static auto read(lua_State* ls, int idx) -> std::optional<std::pair<First, Second>> {	// [-0, +0]
 			if (lua_type(ls, idx) != LUA_TTABLE) {
 				return std::nullopt;
 			}
 
+			lua_checkstack(ls, 1);
 			lua_rawgeti(ls, idx, 1);
 			auto first = LuaStrap::read<First>(ls, -1);
 			lua_pop(ls, 1);
@@ -379,11 +691,14 @@ namespace LuaStrap {
 			return std::optional{ std::pair{*first, *second} };
 		}
 		static void emplace(lua_State* ls, const std::pair<First, Second>& v, int idx) {
-			LuaStrap::write(ls, v.first);
+			LuaStrap::writeReserved(ls, v.first);
 			lua_seti(ls, idx, 1);
-			LuaStrap::write(ls, v.second);
+			LuaStrap::writeReserved(ls, v.second);
 			lua_seti(ls, idx, 2);
 		}
+		static auto tableSize(const std::pair<First, Second>&) -> LuaTableSize { return { 2, 0 }; }
+		static constexpr int luaStackNeed = luaStackNeedAbove(1, maxLuaStackNeed({ LuaStrap::luaStackNeed<First>(), LuaStrap::luaStackNeed<Second>() }));
+		static constexpr bool isBorrowing = LuaStrap::borrowsLuaData<First>() || LuaStrap::borrowsLuaData<Second>();
 	};
 
 	template <>
@@ -393,6 +708,7 @@ namespace LuaStrap {
 		// it simply needs a lua_State* parameter at the end of its parameter list, and the system will supply it.
 		// This parameter shall then be ignored by the caller.
 
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTHREAD) | luaTypeBit(LUA_TNIL) | luaTypeBit(LUA_TNONE);
 		static auto read(lua_State* ls, int idx) -> std::optional<lua_State*> {
 			if (lua_isthread(ls, idx)) {
 				return std::optional{ lua_tothread(ls, idx) };
@@ -404,6 +720,7 @@ namespace LuaStrap {
 				return std::nullopt;
 			}
 		}
+		static constexpr int luaStackNeed = 1;
 		static void write(lua_State* ls, lua_State* v) {
 			lua_checkstack(v, 1);
 			lua_pushthread(v);
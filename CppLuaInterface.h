@@ -5,6 +5,8 @@
 #include <string>
 #include <cassert>
 #include <functional>
+#include <cstdint>
+#include <initializer_list>
 
 namespace LuaStrap {
 	template <typename T>
@@ -38,12 +40,149 @@ namespace LuaStrap {
 		{ LuaStrap::Traits<T>::defaultValue((lua_State*)nullptr) } -> std::convertible_to<T>;
 	};
 
+	// A set of lua types (as returned by lua_type), one bit per type
+	using LuaTypeMask = std::uint32_t;
+	constexpr auto luaTypeBit(int luaType) -> LuaTypeMask {
+		return LuaTypeMask{ 1 } << (luaType + 1);	// +1 for LUA_TNONE
+	}
+	constexpr auto anyLuaType = ~LuaTypeMask{ 0 };
+
+	// The lua types which a T can possibly be read from (when passed as lua data), as declared by the traits.
+	// This allows rejecting an argument of the wrong lua type without attempting to read it.
+	template <typename T>
+	constexpr auto acceptedLuaTypes() -> LuaTypeMask {
+		if constexpr (requires { { LuaStrap::Traits<T>::luaTypes } -> std::convertible_to<LuaTypeMask>; }) {
+			return LuaStrap::Traits<T>::luaTypes;
+		}
+		else if constexpr (LuaInterfacable<T>) {
+			return anyLuaType;
+		}
+		else {
+			return 0;
+		}
+	}
+
+	// What a lua table must look like for 'read' to possibly succeed on it - the length of its array part
+	// (as given by lua_rawlen, i.e. assuming the table has no holes), and the lua types of its array elements.
+	struct LuaArrayShape {
+		int minLength = 0;
+		int maxLength = -1;					// -1 = unlimited
+		LuaTypeMask elemTypes = anyLuaType;
+		bool isArray = true;				// false = the table isn't necessarily an array (only for types which don't declare a shape)
+	};
+	template <typename T>
+	constexpr auto luaArrayShape() -> LuaArrayShape {
+		if constexpr (requires { { LuaStrap::Traits<T>::luaArrayShape } -> std::convertible_to<LuaArrayShape>; }) {
+			return LuaStrap::Traits<T>::luaArrayShape;
+		}
+		else {
+			return { 0, -1, anyLuaType, false };
+		}
+	}
+
+	// The shape of a lua value, as far as 'luaTypes' and 'luaArrayShape' are concerned (see the traits rules).
+	// It's cheap to probe, so it can rule out types before attempting to read them.
+	struct LuaValueShape {
+		int luaType = LUA_TNONE;
+		int arrayLength = 0;							// (for tables)
+		LuaTypeMask firstElemType = luaTypeBit(LUA_TNIL);	// (for tables, if probed)
+		bool isKeyed = false;							// a non-empty table without an array part (if probed)
+
+		static auto probe(lua_State* ls, int idx, bool shouldProbeElems, bool shouldProbeKeys) -> LuaValueShape;	// [-0, +0]
+
+		template <typename T>
+		auto fits() const -> bool {
+			if (!(acceptedLuaTypes<T>() & luaTypeBit(luaType))) {
+				return false;
+			}
+			if (luaType != LUA_TTABLE) {
+				return true;
+			}
+			constexpr auto shape = luaArrayShape<T>();
+			if (arrayLength < shape.minLength || (shape.maxLength != -1 && arrayLength > shape.maxLength)) {
+				return false;
+			}
+			return firstElemType == luaTypeBit(LUA_TNIL) || (shape.elemTypes & firstElemType);
+		}
+	};
+
+	// How many lua stack slots writing a T takes at most (counting the written value itself), or 0 if unknown.
+	// 'write' reserves them all at once, so that writing nested values (e.g. the elems of a vector) needs no further checks.
+	template <typename T>
+	constexpr auto luaStackNeed() -> int {
+		if constexpr (requires { { LuaStrap::Traits<T>::luaStackNeed() } -> std::convertible_to<int>; }) {
+			return LuaStrap::Traits<T>::luaStackNeed();
+		}
+		else if constexpr (requires { { LuaStrap::Traits<T>::luaStackNeed } -> std::convertible_to<int>; }) {
+			return LuaStrap::Traits<T>::luaStackNeed;
+		}
+		else {
+			return 0;
+		}
+	}
+	// Helpers for composing stack needs - both of them propagate an unknown (0) need
+	constexpr auto maxLuaStackNeed(std::initializer_list<int> needs) -> int {
+		auto res = 0;
+		for (auto need : needs) {
+			if (need == 0) {
+				return 0;
+			}
+			res = need > res ? need : res;
+		}
+		return res;
+	}
+	constexpr auto luaStackNeedAbove(int slotsBelow, int need) -> int {
+		return need == 0 ? 0 : slotsBelow + need;
+	}
+
+	// Whether a T read from lua may refer to the memory of the lua value it was read from (like std::string_view does),
+	// as declared by the traits. Such a T is only valid while that lua value is alive, so it's never baked (see 'Bakeable').
+	template <typename T>
+	constexpr auto borrowsLuaData() -> bool {
+		if constexpr (requires { { LuaStrap::Traits<T>::isBorrowing() } -> std::convertible_to<bool>; }) {
+			return LuaStrap::Traits<T>::isBorrowing();
+		}
+		else if constexpr (requires { { LuaStrap::Traits<T>::isBorrowing } -> std::convertible_to<bool>; }) {
+			return LuaStrap::Traits<T>::isBorrowing;
+		}
+		else {
+			return false;
+		}
+	}
+	// Bakeable types can be stored in userdata, outliving the lua values they were read from
+	template <typename T>
+	concept Bakeable = !borrowsLuaData<T>();
+
+	// The sizes of the array and hash parts a new table gets before a T is emplaced into it
+	struct LuaTableSize {
+		int arraySize = 0;
+		int hashSize = 0;
+	};
+	template <typename T>
+	auto luaTableSize(const T& v) -> LuaTableSize {
+		if constexpr (requires { { LuaStrap::Traits<T>::tableSize(v) } -> std::convertible_to<LuaTableSize>; }) {
+			return LuaStrap::Traits<T>::tableSize(v);
+		}
+		else {
+			return {};
+		}
+	}
+
 	// Rules for writing traits
 	// - 'read' shall return an optional<T>, which is empty in case of failure.
+	// - 'luaTypes' (optional) shall be a LuaTypeMask of all the lua types 'read' can possibly succeed on.
+	// - 'luaArrayShape' (optional) shall be a LuaArrayShape of all the tables 'read' can possibly succeed on.
+	//	 Declaring it also marks the type as an array, so variants prefer other alternatives for keyed tables.
 	// - 'emplace' shall be defined for types whose lua representation has object semantics (i.e. a table). It represents
 	//	the act of overwriting, and only types with 'emplace' defined can be passed to bound funcs by mutable reference.
 	// - None of these functions shall signal a lua error, since that would do a longjmp and possibly lead to UB.
 	// - 'write'/'emplace' are free to assume at least 1 free stack space. 'read' may not assume any free space.
+	// - 'luaStackNeed' (optional) shall be a constant (or a constexpr function) of the stack slots 'write' takes at most -
+	//	 see 'luaStackNeed<T>'. If declared, 'write'/'emplace' may assume that many free slots (minus the table for
+	//	 'emplace'), and should write nested values by 'writeReserved'. Recursive types can't have a known need.
+	// - 'isBorrowing' (optional) shall be true (or a constexpr function returning true) if 'read' may return a T referring
+	//	 to the memory of the lua value - see 'borrowsLuaData<T>'. Traits of types containing other types shall propagate it.
+	// - 'tableSize' (optional) shall return the LuaTableSize a value will need when emplaced, so 'write' can pre-size its table.
 	// - 'read' should generally not push anything on stack, but some special types require it (see LuaRepresObjects.h).
 	//	 Doing so is allowed, but results in the type only being usable in a few cases.
 	//	 Also, they must be destructible even after their stack space was deleted.
@@ -59,28 +198,38 @@ namespace LuaStrap {
 
 		return Tr::read(ls, idx);
 	}
+	// Like 'write', but if T's stack need is known, assumes the caller has reserved it (e.g. as part of its own need)
 	template <LuaWritable T>
-	void write(lua_State* ls, const T& t)
+	void writeReserved(lua_State* ls, const T& t)
 	{
 		using Tr = LuaStrap::Traits<T>;
 
+		if constexpr (luaStackNeed<T>() == 0) {
+			lua_checkstack(ls, 2);
+		}
 		if constexpr (requires { Tr::write(ls, t); }) {
-			lua_checkstack(ls, 1);
 			Tr::write(ls, t);
 		}
 		else {
-			lua_checkstack(ls, 2);
-			lua_createtable(ls, 0, 0);
+			auto size = luaTableSize(t);
+			lua_createtable(ls, size.arraySize, size.hashSize);
 			Tr::emplace(ls, t, lua_gettop(ls));
 		}
-
+	}
+	template <LuaWritable T>
+	void write(lua_State* ls, const T& t)
+	{
+		if constexpr (luaStackNeed<T>() > 0) {
+			lua_checkstack(ls, luaStackNeed<T>());
+		}
+		writeReserved(ls, t);
 	}
 	template <LuaWritable T>
 	void emplace(lua_State* ls, const T& t, int idx) requires
 		requires { LuaStrap::Traits<T>::emplace(ls, t, idx); }
 	{
 		idx = lua_absindex(ls, idx);
-		lua_checkstack(ls, 1);
+		lua_checkstack(ls, luaStackNeed<T>() > 2 ? luaStackNeed<T>() - 1 : 1);
 		LuaStrap::Traits<T>::emplace(ls, t, idx);
 	}
 
@@ -106,41 +255,79 @@ namespace LuaStrap {
 		return *val;
 	}
 
+	// Like 'sinkArrayElem', but assumes an absolute 'tblIdx' and 1 free stack space
 	template <typename T>
-	auto sinkArrayElem(lua_State* ls, int tblIdx, int elmKey, std::invocable<T&&> auto&& sink) {	// [-0, +0 (unless sink pushes), m]
-		tblIdx = lua_absindex(ls, tblIdx);
-		lua_checkstack(ls, 1);
+	auto sinkArrayElemReserved(lua_State* ls, int tblIdx, lua_Integer elmKey, std::invocable<T&&> auto&& sink) -> int {	// [-0, +0 (unless sink pushes), m]
+		auto elemType = lua_rawgeti(ls, tblIdx, elmKey);
 
-		lua_geti(ls, tblIdx, elmKey);
-		if (lua_isnil(ls, -1)) {
+		// Numbers are converted directly, mirroring their traits
+		if constexpr (std::floating_point<T>) {
+			auto isNum = 0;
+			auto val = lua_tonumberx(ls, -1, &isNum);
 			lua_pop(ls, 1);
-			return 0;
+			if (!isNum) {
+				return elemType == LUA_TNIL ? 0 : -1;
+			}
+			sink(static_cast<T>(val));
+			return 1;
 		}
-		auto val = LuaStrap::readNoPush<T>(ls, -1);
-		lua_pop(ls, 1);
-		if (!val) {
-			return -1;
+		else if constexpr (std::integral<T> && !std::same_as<T, bool>) {
+			auto isInt = lua_isinteger(ls, -1);
+			auto val = lua_tointeger(ls, -1);
+			lua_pop(ls, 1);
+			if (!isInt) {
+				return elemType == LUA_TNIL ? 0 : -1;
+			}
+			sink(static_cast<T>(val));
+			return 1;
+		}
+		else {
+			if (elemType == LUA_TNIL) {
+				lua_pop(ls, 1);
+				return 0;
+			}
+			auto val = LuaStrap::readNoPush<T>(ls, -1);
+			lua_pop(ls, 1);
+			if (!val) {
+				return -1;
+			}
+			sink(std::move(*val));
+			return 1;
 		}
-		sink(std::move(*val));
-		return 1;
+	}
+	// Reads the elem of a lua array (raw, i.e. without invoking metamethods) and sinks it.
+	// Returns 1 if it was sunk, 0 if it's nil, -1 in case of wrong format.
+	template <typename T>
+	auto sinkArrayElem(lua_State* ls, int tblIdx, int elmKey, std::invocable<T&&> auto&& sink) {	// [-0, +0 (unless sink pushes), m]
+		tblIdx = lua_absindex(ls, tblIdx);
+		lua_checkstack(ls, 1);
+		return sinkArrayElemReserved<T>(ls, tblIdx, elmKey, sink);
 	}
 
-	// For a lua array at idx, successively reads each of the elems and sinks them.
-	// Returns how many elems were read/sunk, -1 in case of wrong format.
+	// For a lua array at idx, whose length (as given by lua_rawlen) is known, successively reads each of the elems
+	// (up to the first nil one) and sinks them. Returns how many elems were read/sunk, -1 in case of wrong format.
 	template <typename T>
-	auto readArrayUnlimited(lua_State* ls, int idx, std::invocable<T&&> auto&& sink) {
+	auto readArrayOfLength(lua_State* ls, int idx, int length, std::invocable<T&&> auto&& sink) -> int {
 		idx = lua_absindex(ls, idx);
+		lua_checkstack(ls, 1);
 
-		if (lua_type(ls, idx) != LUA_TTABLE) {
-			return -1;
-		}
-
-		for (auto i = 0;; ++i) {
-			auto sinkRes = sinkArrayElem<T>(ls, idx, i + 1, sink);
+		for (auto i = 0; i < length; ++i) {
+			auto sinkRes = sinkArrayElemReserved<T>(ls, idx, i + 1, sink);
 			if (sinkRes == 1)		{}
 			else if (sinkRes == 0)	{ return i; }
 			else /*sinkRes == -1*/	{ return -1; }
 		}
+		return length;
+	}
+
+	// For a lua array at idx, successively reads each of the elems and sinks them. The elems are accessed raw,
+	// i.e. metamethods aren't invoked. Returns how many elems were read/sunk, -1 in case of wrong format.
+	template <typename T>
+	auto readArrayUnlimited(lua_State* ls, int idx, std::invocable<T&&> auto&& sink) {
+		if (lua_type(ls, idx) != LUA_TTABLE) {
+			return -1;
+		}
+		return readArrayOfLength<T>(ls, idx, int(lua_rawlen(ls, idx)), sink);
 	}
 	template <typename T>
 	auto readArrayUnlimited(lua_State* ls, int idx, std::output_iterator<T> auto&& dest) {
@@ -150,25 +337,15 @@ namespace LuaStrap {
 	// Like 'readArrayUnlimited', but the array must have at most 'capacity' elems
 	template <typename T>
 	auto readArrayUpTo(lua_State* ls, int idx, int capacity, std::invocable<T&&> auto&& sink) {
-		idx = lua_absindex(ls, idx);
-
 		if (lua_type(ls, idx) != LUA_TTABLE) {
 			return -1;
 		}
 
-		lua_geti(ls, idx, capacity + 1);
-		if (!lua_isnil(ls, -1)) {
+		auto length = int(lua_rawlen(ls, idx));
+		if (length > capacity) {
 			return -1;
 		}
-		lua_pop(ls, 1);
-				
-		for (auto i = 0; i < capacity; ++i) {
-			auto sinkRes = sinkArrayElem<T>(ls, idx, i + 1, sink);
-			if (sinkRes == 1)		{}
-			else if (sinkRes == 0)	{ return i; }
-			else /*sinkRes == -1*/	{ return -1; }
-		}
-		return capacity;
+		return readArrayOfLength<T>(ls, idx, length, sink);
 	}
 	template <typename T>
 	auto readArrayUpTo(lua_State* ls, int idx, int capacity, std::output_iterator<T> auto&& dest) {
@@ -179,7 +356,7 @@ namespace LuaStrap {
 	}
 
 	// Called in case a user-caused error happens in a spot which can't longjmp (these spots are rare).
-	// Terminates by default, can be customized by the user.
+	// Terminates by default, can be customized by the user (before any lua_States start running on other threads).
 	extern std::function<void(std::string_view)> edgeCaseErrorHandler;
 
 	// Some types (see LuaRepresObjects.h) generate garbage as a side effect of their operation.
@@ -1,7 +1,7 @@
 #pragma once
 #include "CppLuaInterface.h"
 #include "Helpers.h"
-#include <map>
+#include <cstdint>
 
 namespace LuaStrap {
 
@@ -75,15 +75,59 @@ namespace LuaStrap {
 	};
 	auto dataDispatch(lua_State* ls, int idx) -> AnyData;
 
+	// Every kind of metatable LuaStrap uses (one per baked type, plus the ones for pending and indirect data) has
+	// a dense integer ID. Each lua_State keeps its metatables in a single table stored in the lua registry, indexed
+	// by these IDs - so fetching a metatable is two raw lookups, and it all goes away together with the lua_State.
+	// Nothing here is shared between lua_States except the IDs, so independent lua_States can run on different threads.
+	constexpr int pendingDataTypeId = 1;
+	constexpr int indirectDataTypeId = 2;
+	auto newTypeId() -> int;
+	template <typename T>
+	auto typeId() -> int {
+		static const auto id = newTypeId();
+		return id;
+	}
+	void fetchMetatable(lua_State* ls, int typeId, void(*build)(lua_State*));	// [-0, +1, m]
+		// ^ 'build' is invoked (and must push the new metatable) if the metatable doesn't exist in this lua_State yet
+
+	// Every userdatum created by LuaStrap starts with this header, followed by the payload. The type ID says
+	// what the userdatum is (pending data, indirect data, or baked data of a particular type), so that
+	// classifying an argument doesn't require touching its metatable.
+	struct UserdataHeader {
+		std::uint32_t magic;
+		int typeId;
+	};
+	constexpr std::uint32_t userdataMagic = 0x4C537472;	// "LStr"
+	template <typename T>
+	constexpr auto userdataPayloadOffset = std::max(sizeof(UserdataHeader), alignof(T));
+
+	template <typename T, typename... Args>
+	auto newUserdata(lua_State* ls, int typeId, Args&&... args) -> T* {	// [-0, +1, m]
+		auto* udata = static_cast<char*>(lua_newuserdata(ls, userdataPayloadOffset<T> + sizeof(T)));
+		new (udata) UserdataHeader{ userdataMagic, typeId };
+		return new (udata + userdataPayloadOffset<T>) T{ std::forward<Args>(args)... };
+	}
+	inline auto userdataHeader(lua_State* ls, int idx) -> UserdataHeader* {	// [-0, +0]
+		// nullptr if the value isn't a userdatum created by LuaStrap
+		if (lua_type(ls, idx) != LUA_TUSERDATA || lua_rawlen(ls, idx) < sizeof(UserdataHeader)) {
+			return nullptr;
+		}
+		auto* header = static_cast<UserdataHeader*>(lua_touserdata(ls, idx));
+		return header->magic == userdataMagic ? header : nullptr;
+	}
+	template <typename T>
+	auto userdataPayload(lua_State* ls, int idx) -> T* {	// [-0, +0]
+		return reinterpret_cast<T*>(static_cast<char*>(lua_touserdata(ls, idx)) + userdataPayloadOffset<T>);
+	}
+
 	struct{} bakedReturnValueTag;
 		// ^ this is what a bound func shall return if it directly puts its result on the lua stack,
 		// instead of returning a c++ value to be translated into lua
 
-	template <typename T, typename... Args>
+	template <Bakeable T, typename... Args>
 	auto makeBakedData(const Args&... args, lua_State* ls) {	// [-0, +1, m]
 		lua_checkstack(ls, 2);
-		auto* dest = lua_newuserdata(ls, sizeof(T));
-		auto* obj = new (dest) T{ args... };
+		newUserdata<T>(ls, typeId<T>(), args...);
 		BakedData::metatable<T>(ls);
 		lua_setmetatable(ls, -2);
 		return bakedReturnValueTag;
@@ -102,11 +146,8 @@ namespace LuaStrap {
 
 	template <typename T>
 	void BakedData::metatable(lua_State* ls) {	// [-0, +1]
-		static auto refsPerLs = std::map<lua_State*, int>{};
-		auto mainThread = getMainThread(ls);
-		lua_checkstack(ls, 2);
-
-		if (auto ref = refsPerLs.find(mainThread); ref == refsPerLs.end()) {
+		fetchMetatable(ls, typeId<T>(), [](lua_State* ls) {
+			lua_checkstack(ls, 2);
 			lua_createtable(ls, 0, 0); {
 				lua_pushvalue(ls, -1);
 				lua_setfield(ls, -2, "__index");
@@ -114,7 +155,7 @@ namespace LuaStrap {
 				lua_pushcfunction(ls, [](lua_State* ls) {
 					// (userdatum)
 					if (lua_isuserdata(ls, 1)) {
-						static_cast<T*>(lua_touserdata(ls, 1))->~T();
+						userdataPayload<T>(ls, 1)->~T();
 					}
 					return 0;
 				});
@@ -123,16 +164,12 @@ namespace LuaStrap {
 				if constexpr (LuaWritable<T>) {
 					lua_pushcfunction(ls, [](lua_State* ls) {
 						// (userdata of type T)
-						auto hasMt = lua_getmetatable(ls, 1);
-						if (!hasMt) {
-							return luaL_error(ls, "Wrong argument for 'toLuaData'. Note: functions 'toLuaData' and 'toBakedData' of a baked object's metatable are meant for internal use. Use the library provided functions 'unbaked' and 'markedForBaking' instead.");
-						}
-						BakedData::metatable<T>(ls);
-						if (!lua_rawequal(ls, -2, -1)) {
+						auto* header = userdataHeader(ls, 1);
+						if (!header || header->typeId != typeId<T>()) {
 							return luaL_error(ls, "Wrong argument for 'toLuaData'. Note: functions 'toLuaData' and 'toBakedData' of a baked object's metatable are meant for internal use. Use the library provided functions 'unbaked' and 'markedForBaking' instead.");
 						}
 
-						auto* val = static_cast<T*>(lua_touserdata(ls, 1));
+						auto* val = userdataPayload<T>(ls, 1);
 						LuaStrap::write(ls, *val);
 						return 1;
 					});
@@ -142,8 +179,7 @@ namespace LuaStrap {
 				if constexpr (LuaInterfacable<T>) {
 					lua_pushcfunction(ls, [](lua_State* ls) {
 						// (luarepres of type T)
-						auto* dest = lua_newuserdata(ls, sizeof(T));
-						new (dest) T{ LuaStrap::unconditionalRead<T>(ls, 1) };
+						newUserdata<T>(ls, typeId<T>(), LuaStrap::unconditionalRead<T>(ls, 1));
 						BakedData::metatable<T>(ls);
 						lua_setmetatable(ls, -2);
 						return 1;
@@ -164,19 +200,13 @@ namespace LuaStrap {
 					);
 				}
 			}
-			lua_pushvalue(ls, -1);
-			refsPerLs.emplace(mainThread, luaL_ref(ls, LUA_REGISTRYINDEX));
-		}
-		else {
-			lua_rawgeti(ls, LUA_REGISTRYINDEX, ref->second);
-		}
+		});
 	}
-	template <typename T>
+	template <Bakeable T>
 	auto bakePendingData(lua_State* ls) -> T* {	// [-0, +n], -1 = pendingData
 		// Turns pending data into indirect data
 		lua_checkstack(ls, 1);
-		void* pdata = lua_touserdata(ls, -1);
-		auto luaDataStackObj = *static_cast<int*>(pdata);
+		auto luaDataStackObj = *userdataPayload<int>(ls, -1);
 		lua_rawgeti(ls, LUA_REGISTRYINDEX, luaDataStackObj);
 
 		// -2 = pendingData, -1 = corresponding luaData
@@ -187,14 +217,14 @@ namespace LuaStrap {
 			lua_checkstack(ls, 2);
 
 			// Overwrite the data referred to by "ref" with the baked data
-			auto* dest = lua_newuserdata(ls, sizeof(T));
-			auto* udata = new (dest) T{ std::move(*readAttempt) }; {
+			auto* udata = newUserdata<T>(ls, typeId<T>(), std::move(*readAttempt)); {
 				BakedData::metatable<T>(ls);
 				lua_setmetatable(ls, -2);
 			}
 			lua_rawseti(ls, LUA_REGISTRYINDEX, luaDataStackObj);
 
 			// Mark subject as indirect userdata
+			userdataHeader(ls, pendingDataIdx)->typeId = indirectDataTypeId;
 			IndirectData::metatable(ls);
 			lua_setmetatable(ls, pendingDataIdx);
 
@@ -218,24 +248,30 @@ namespace LuaStrap {
 	}
 	template <typename T>
 	auto PendingData::readAs() const -> PotentialOwner<T> {
-		lua_checkstack(ls, 1);
-		lua_pushvalue(ls, idx);
-
-		auto pendingDataIdx = lua_gettop(ls);
-		auto* bakedData = bakePendingData<T>(ls);
-		popIfOnTop(ls, pendingDataIdx);
-
-		if (bakedData) {
-			return bakedData;
+		if constexpr (!Bakeable<T>) {
+			// Read the lua data without baking it (which would leave the T referring to a collectable lua value)
+			return IndirectData{ ls, idx }.readAs<T>();
 		}
 		else {
-			return std::monostate{};
+			lua_checkstack(ls, 1);
+			lua_pushvalue(ls, idx);
+
+			auto pendingDataIdx = lua_gettop(ls);
+			auto* bakedData = bakePendingData<T>(ls);
+			popIfOnTop(ls, pendingDataIdx);
+
+			if (bakedData) {
+				return bakedData;
+			}
+			else {
+				return std::monostate{};
+			}
 		}
 	}
 	template <typename T>
 	auto IndirectData::readAs() const -> PotentialOwner<T> {
 		lua_checkstack(ls, 1);
-		auto luaStackObj = *static_cast<int*>(lua_touserdata(ls, idx));
+		auto luaStackObj = *userdataPayload<int>(ls, idx);
 		lua_rawgeti(ls, LUA_REGISTRYINDEX, luaStackObj);
 
 		auto referencedDataIdx = lua_gettop(ls);
@@ -246,12 +282,17 @@ namespace LuaStrap {
 	}
 	template <typename T>
 	auto BakedData::readAs() const -> PotentialOwner<T> {
-		lua_checkstack(ls, 2);
-		BakedData::metatable<T>(ls);
-		auto hasMt = lua_getmetatable(ls, idx);
-		assert(hasMt && lua_rawequal(ls, -2, -1));
-		lua_pop(ls, 2);
-		return static_cast<T*>(lua_touserdata(ls, idx));
+		if constexpr (!Bakeable<T>) {
+			return std::monostate{};	// (can't be baked)
+		}
+		else {
+			// The header was already validated by 'dataDispatch'
+			auto* header = static_cast<const UserdataHeader*>(lua_touserdata(ls, idx));
+			if (header->typeId != typeId<T>()) {
+				return std::monostate{};
+			}
+			return userdataPayload<T>(ls, idx);
+		}
 	}
 	template <typename T>
 	auto FailData::readAs() const -> PotentialOwner<T> {
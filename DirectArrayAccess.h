@@ -0,0 +1,160 @@
+#pragma once
+#include "CppLuaInterface.h"
+#include <array>
+#include <concepts>
+
+// Opt-in (by defining LUASTRAP_DIRECT_ARRAY_ACCESS): arrays of numbers (and fixed-size arrays of them) are converted
+// by accessing the array part of lua tables directly, through lua's internal data layout, instead of making several
+// C API calls per elem. This requires lua's internal headers (lobject.h etc.) on the include path, a statically linked
+// lua, and LuaStrap being compiled against the exact lua version that runs it (5.3 or 5.4).
+// Tables which don't fit (elems outside the array part, holes, elems of other types) go through the public API instead.
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+extern "C" {
+#include "lobject.h"
+#include "lstate.h"
+#include "ltable.h"
+}
+#if LUA_VERSION_NUM != 503 && LUA_VERSION_NUM != 504
+#error "LUASTRAP_DIRECT_ARRAY_ACCESS supports lua 5.3 and 5.4 only"
+#endif
+#endif
+
+namespace LuaStrap {
+	template <typename T>
+	struct IsStdArray : std::false_type {};
+	template <typename T, size_t size>
+	struct IsStdArray<std::array<T, size>> : std::true_type {};
+
+	// Elems of lua arrays which can be read directly (numbers, and fixed-size arrays of such elems)
+	template <typename T>
+	constexpr auto isDirectlyReadable() -> bool {
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+		if constexpr (IsStdArray<T>::value) {
+			return isDirectlyReadable<typename T::value_type>();
+		}
+		else {
+			return std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+		}
+#else
+		return false;
+#endif
+	}
+	// Elems of lua arrays which can be written directly (numbers)
+	template <typename T>
+	constexpr auto isDirectlyWritable() -> bool {
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+		return std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+#else
+		return false;
+#endif
+	}
+
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+	namespace Direct {
+		inline auto arrayPartSize(const Table* t) -> int {
+#if LUA_VERSION_NUM == 503
+			return int(t->sizearray);
+#else
+			return int(luaH_realasize(t));
+#endif
+		}
+
+		// Reads a lua value the way the traits of T would, false if it's not possible directly
+		template <typename T>
+		auto readValue(const TValue* val, T& dest) -> bool;
+
+		// Reads the first 'length' elems of a table's array part, which must be followed by nothing (so the table's
+		// lua_rawlen is 'length')
+		template <typename T>
+		auto readArrayPart(const Table* t, int length, T* dest) -> bool {
+			auto size = arrayPartSize(t);
+			if (length > size || (length == size ? !isdummy(t) : !ttisnil(&t->array[length]))) {
+				return false;
+			}
+
+			const auto* elems = t->array;
+			auto isOk = true;
+			for (auto i = 0; i < length; ++i) {
+				isOk &= readValue(&elems[i], dest[i]);
+			}
+			return isOk;
+		}
+
+		template <typename T>
+		auto readValue(const TValue* val, T& dest) -> bool {
+			if constexpr (IsStdArray<T>::value) {
+				return ttistable(val) && readArrayPart(hvalue(val), int(dest.size()), dest.data());
+			}
+			else if constexpr (std::floating_point<T>) {
+				// mirrors Traits<Float>, except for strings (left to the public API)
+				if (ttisfloat(val)) {
+					dest = static_cast<T>(fltvalue(val));
+					return true;
+				}
+				else if (ttisinteger(val)) {
+					dest = static_cast<T>(ivalue(val));
+					return true;
+				}
+				return false;
+			}
+			else {
+				// mirrors Traits<Int>
+				if (ttisinteger(val)) {
+					dest = static_cast<T>(ivalue(val));
+					return true;
+				}
+				return false;
+			}
+		}
+	}
+#endif
+
+	// Reads the lua array at idx, whose lua_rawlen is 'length', into 'dest' directly (see LUASTRAP_DIRECT_ARRAY_ACCESS).
+	// Returns false if that's not possible, in which case the contents of 'dest' are unspecified.
+	template <typename T>
+	auto readArrayDirect(lua_State* ls, int idx, int length, T* dest) -> bool {	// [-0, +0]
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+		if constexpr (isDirectlyReadable<T>()) {
+			return lua_type(ls, idx) == LUA_TTABLE &&
+				Direct::readArrayPart(static_cast<const Table*>(lua_topointer(ls, idx)), length, dest);
+		}
+#endif
+		return false;
+	}
+	// Writes 'src' into elems 1 to 'length' of the table at idx directly (see LUASTRAP_DIRECT_ARRAY_ACCESS).
+	// Only possible if the table's array part is long enough, or the table is empty (then its array part gets resized).
+	// Returns false if that's not possible, in which case the table is unchanged.
+	template <typename T>
+	auto writeArrayDirect(lua_State* ls, int idx, const T* src, int length) -> bool {	// [-0, +0, m]
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+		if constexpr (isDirectlyWritable<T>()) {
+			if (lua_type(ls, idx) != LUA_TTABLE) {
+				return false;
+			}
+			auto* t = static_cast<Table*>(const_cast<void*>(lua_topointer(ls, idx)));
+			if (t->metatable) {
+				return false;	// absent elems would be subject to '__newindex'
+			}
+			if (Direct::arrayPartSize(t) < length) {
+				if (Direct::arrayPartSize(t) != 0 || !isdummy(t)) {
+					return false;
+				}
+				luaH_resize(ls, t, length, 0);
+			}
+
+			// Numbers aren't collectable, so no GC barrier is needed
+			auto* elems = t->array;
+			for (auto i = 0; i < length; ++i) {
+				if constexpr (std::floating_point<T>) {
+					setfltvalue(&elems[i], static_cast<lua_Number>(src[i]));
+				}
+				else {
+					setivalue(&elems[i], static_cast<lua_Integer>(src[i]));
+				}
+			}
+			return true;
+		}
+#endif
+		return false;
+	}
+}
@@ -3,28 +3,124 @@
 #include <set>
 #include <array>
 #include <functional>
+#include <string_view>
+
+// Every N-th call of a trusted binding (see 'pushTrustedFunc') validates its args like an ordinary binding would,
+// raising the usual error on bad args. 0 = never, 1 = always (i.e. trusted bindings become ordinary ones).
+#ifndef LUASTRAP_VERIFY_TRUSTED_EVERY
+#define LUASTRAP_VERIFY_TRUSTED_EVERY 0
+#endif
 
 namespace LuaStrap {
 	struct TryToCallResult {
 		size_t howManyArgsRead;
 		size_t howManyArgsTotal;
-		std::string errMsg = "";
+		CallError error = {};	// empty in case of success
 	};
 
+	// Returns the lua stack position of the first arg (out of the 'top' supplied) whose lua type can't possibly be read
+	// as the corresponding T (see 'acceptedLuaTypes'), or 0 if there is none. Userdata is never rejected here, since
+	// baked data is accepted regardless of the lua types declared by the traits.
+	template <typename... Ts>
+	auto findLuaTypeMismatch(lua_State* ls, int top) -> int {		// [-0, +0]
+		auto mismatchIdx = 0;
+		auto step = [&]<typename T>(int idx) {
+			if constexpr (acceptedLuaTypes<T>() != anyLuaType) {
+				if (idx <= top) {
+					auto type = lua_type(ls, idx);
+					if (type != LUA_TUSERDATA && !(acceptedLuaTypes<T>() & luaTypeBit(type))) {
+						mismatchIdx = idx;
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+		auto idx = 0;
+		auto dummy = (step.template operator()<Ts>(++idx) && ...);
+		return mismatchIdx;
+	}
+
+	// Within a single call of an overloaded function, the args translated for one overload can be reused by the
+	// next ones - each arg is translated to a given c++ type at most once. An ArgMemo holds one slot per distinct
+	// (arg position, c++ type) pair among the overloads.
+	template <int position, typename T>
+	struct ArgMemoSlot {
+		PotentialOwner<T> value;
+		bool isTranslated = false;	// if true, 'value' is the result of the translation (empty if it failed)
+	};
+	template <typename... Slots>
+	struct ArgMemo {
+		std::tuple<Slots...> slots;
+		bool isValid = true;	// cleared once an overload got invoked (it may have modified the args)
+
+		template <int position, typename T>
+		auto find() -> ArgMemoSlot<position, T>* {
+			if constexpr ((std::same_as<Slots, ArgMemoSlot<position, T>> || ...)) {
+				return isValid ? &get<ArgMemoSlot<position, T>>(slots) : nullptr;
+			}
+			else {
+				return nullptr;
+			}
+		}
+
+		template <typename Slot>
+		using With = std::conditional_t<(std::same_as<Slots, Slot> || ...), ArgMemo, ArgMemo<Slots..., Slot>>;
+	};
+	using NoArgMemo = ArgMemo<>;
+
+	template <typename Memo, typename... NewSlots>
+	struct ArgMemoWithSlots {
+		using type = Memo;
+	};
+	template <typename Memo, typename Slot, typename... Rest>
+	struct ArgMemoWithSlots<Memo, Slot, Rest...> {
+		using type = typename ArgMemoWithSlots<typename Memo::template With<Slot>, Rest...>::type;
+	};
+	template <typename... Slots>
+	using ArgMemoOfSlots = typename ArgMemoWithSlots<NoArgMemo, Slots...>::type;
+
+	template <typename... Args>
+	constexpr auto argMemoSlots(std::tuple<Args...>*) {
+		return [] <int... indices>(std::integer_sequence<int, indices...>) {
+			return (std::tuple<ArgMemoSlot<indices, std::decay_t<Args>>...>*)nullptr;
+		}(std::make_integer_sequence<int, sizeof...(Args)>{});
+	}
+	template <typename Ret, typename... Args>
+	constexpr auto paramTypes(Ret(*)(Args...)) { return (std::tuple<Args...>*)nullptr; }
+	template <typename Ret, typename Class, typename... Args>
+	constexpr auto paramTypes(Ret(Class::*)(Args...)) { return (std::tuple<Class&, Args...>*)nullptr; }
+	template <typename Ret, typename Class, typename... Args>
+	constexpr auto paramTypes(Ret(Class::*)(Args...) const) { return (std::tuple<const Class&, Args...>*)nullptr; }
+
+	template <typename... Fs>
+	using ArgMemoFor = UnwrapTuple<ArgMemoOfSlots, decltype(std::tuple_cat(*argMemoSlots(paramTypes(std::declval<Fs>()))...))>;
+
 	// Calls a c++ invocable (of format [-0, +n, m]), assuming the arguments are represented at lua stack positions 1 to n.
 	// The arguments can be in any format (see DataTypes.h).
-	// In case of failure, returns an error message (empty string in case of success).
-	template <typename Invoc, typename Ret, typename... Args>
+	// In case of failure, returns the error (see CallError), which is empty in case of success.
+	template <typename Invoc, typename Ret, typename... Args, typename Memo>
 		requires std::invocable<Invoc, Args...>
-	auto tryToCallRaw(lua_State* ls, Invoc f) -> TryToCallResult {		// [-0, +n, m]
+	auto tryToCallRaw(lua_State* ls, Invoc f, Memo& memo) -> TryToCallResult {		// [-0, +n, m]
 		auto [minArgCount, maxArgCount] = getMinMaxArgumentCount<Args...>();
 		auto origTop = lua_gettop(ls);
 		if (!(origTop >= minArgCount && origTop <= maxArgCount)) {
-			return { 0, sizeof...(Args), wrongArgumentCountError(minArgCount, maxArgCount, origTop) };
+			return { 0, sizeof...(Args), { CallErrorCode::wrongArgumentCount, { int(minArgCount), int(maxArgCount), origTop } } };
+		}
+		if (auto mismatchIdx = findLuaTypeMismatch<std::decay_t<Args>...>(ls, origTop); mismatchIdx != 0) {
+			return { size_t(mismatchIdx) - 1, sizeof...(Args), { CallErrorCode::failedToReadArgument, { mismatchIdx } } };
 		}
 
-		// Translate args from lua to c++
-		auto translatedArgs = std::tuple<PotentialOwner<std::decay_t<Args>>...>{};
+		// Translate args from lua to c++, into the memo where possible
+		auto ownArgs = std::tuple<PotentialOwner<std::decay_t<Args>>...>{};
+		auto translatedArgs = [&]<int... indices>(std::integer_sequence<int, indices...>) {
+			auto slotFor = [&]<int index, typename Arg>() -> PotentialOwner<std::decay_t<Arg>>* {
+				auto* memoSlot = memo.template find<index, std::decay_t<Arg>>();
+				return memoSlot ? &memoSlot->value : &get<index>(ownArgs);
+			};
+			return std::tuple{ slotFor.template operator()<indices, Args>()... };
+		}(std::make_integer_sequence<int, sizeof...(Args)>{});
+
 		auto translationRes = [&] <int... indices>(std::integer_sequence<int, indices...> intSeq) -> std::optional<TryToCallResult>
 		{
 			// Read the args from the left, [first-supplied-arg to last-supplied-arg]
@@ -34,8 +130,18 @@ namespace LuaStrap {
 				if (index >= origTop){
 					return false;
 				}
-				get<index>(translatedArgs) = dataDispatch(ls, index + 1).readAs<std::decay_t<Arg>>();
-				if (!get<index>(translatedArgs)) {
+				auto& arg = *get<index>(translatedArgs);
+				auto* memoSlot = memo.template find<index, std::decay_t<Arg>>();
+				if (!memoSlot || !memoSlot->isTranslated) {
+					auto topBeforeRead = lua_gettop(ls);
+					arg = dataDispatch(ls, index + 1).readAs<std::decay_t<Arg>>();
+					if (memoSlot) {
+						// Values which keep something on the lua stack (see LuaRepresObjects.h) are not reused,
+						// since the stack is reset whenever an overload fails.
+						memoSlot->isTranslated = (lua_gettop(ls) == topBeforeRead);
+					}
+				}
+				if (!arg) {
 					failedArgLuaIdx = index + 1;
 					return false;
 				}
@@ -47,7 +153,7 @@ namespace LuaStrap {
 			if (failedArgLuaIdx != 0) {
 				lua_settop(ls, origTop);
 				return TryToCallResult{
-					size_t(failedArgLuaIdx) - 1, sizeof...(Args), std::string{ "Failed reading argument #" } + std::to_string(failedArgLuaIdx) + "."
+					size_t(failedArgLuaIdx) - 1, sizeof...(Args), { CallErrorCode::failedToReadArgument, { failedArgLuaIdx } }
 				};
 			}
 
@@ -57,7 +163,7 @@ namespace LuaStrap {
 				auto step = [&]<int reverseIndex>{
 					using Arg = std::tuple_element_t<reverseIndex, std::tuple<Args...>>;
 					if constexpr (LuaInterfacableWithDefault<Arg>) {
-						auto success = get<reverseIndex>(translatedArgs) = LuaStrap::Traits<Arg>::defaultValue(ls);
+						auto success = *get<reverseIndex>(translatedArgs) = LuaStrap::Traits<Arg>::defaultValue(ls);
 						assert(success);
 					}
 				};
@@ -74,32 +180,32 @@ namespace LuaStrap {
 		}
 
 		// Invoke the invocable
+		memo.isValid = false;
 		if constexpr (std::is_same_v<Ret, void> || std::is_same_v<Ret, decltype(bakedReturnValueTag)>) {
 			std::apply(
-				[&](PotentialOwner<std::decay_t<Args>>&... arg) { return std::invoke(f, *arg...); },
+				[&](PotentialOwner<std::decay_t<Args>>*... arg) { return std::invoke(f, **arg...); },
 				translatedArgs
 			);
 		}
 		else {
-			lua_checkstack(ls, 1);
 			LuaStrap::write(ls, std::apply(
-				[&](PotentialOwner<std::decay_t<Args>>&... arg) { return std::invoke(f, *arg...); },
+				[&](PotentialOwner<std::decay_t<Args>>*... arg) { return std::invoke(f, **arg...); },
 				translatedArgs
 			));
 		}
 
 		// For arguments taken by mutable reference, and passed in as lua data, emplace their new value into their lua representation
-		auto res = TryToCallResult{ sizeof...(Args), sizeof...(Args), "" };
+		auto res = TryToCallResult{ sizeof...(Args), sizeof...(Args) };
 		auto emplaceArg = [&]<int index> {
 			using ArgType = std::tuple_element_t<index, std::tuple<Args...>>;
 			if constexpr (std::is_lvalue_reference_v<ArgType> && !std::is_const_v<std::remove_reference_t<ArgType>>) {
-				if (auto* val = get_if<1>(&get<index>(translatedArgs))) {
+				if (auto* val = get_if<1>(get<index>(translatedArgs))) {
 					if constexpr (requires{ LuaStrap::emplace(ls, *val, index + 1); }) {
 						LuaStrap::emplace(ls, *val, index + 1);
 						return true;
 					}
 					else {
-						res = { sizeof...(Args), sizeof...(Args), failedToEmplaceError(typeid(ArgType).name()) };
+						res = { sizeof...(Args), sizeof...(Args), { CallErrorCode::failedToEmplace, {}, typeInfos<ArgType>(), 1 } };
 						return false;
 					}
 				}
@@ -115,17 +221,147 @@ namespace LuaStrap {
 
 		return res;
 	}
+	template <typename Invoc, typename Ret, typename... Args>
+		requires std::invocable<Invoc, Args...>
+	auto tryToCallRaw(lua_State* ls, Invoc f) -> TryToCallResult {		// [-0, +n, m]
+		auto noMemo = NoArgMemo{};
+		return tryToCallRaw<Invoc, Ret, Args...>(ls, f, noMemo);
+	}
+	// Parameters and return values of these types can be translated directly, without the generic machinery
+	template <typename T>
+	concept PrimitiveParam =
+		(std::integral<std::decay_t<T>> || std::floating_point<std::decay_t<T>> ||
+			std::same_as<std::decay_t<T>, std::string> || std::same_as<std::decay_t<T>, std::string_view>)
+		&& !(std::is_lvalue_reference_v<T> && !std::is_const_v<std::remove_reference_t<T>>) && !std::is_rvalue_reference_v<T>;
 	template <typename Ret, typename... Args>
-	auto tryToCall(lua_State* ls, Ret(*f)(Args...)) {
-		return tryToCallRaw<Ret(*)(Args...), Ret, Args...>(ls, f);
+	concept PrimitiveSignature = (std::same_as<Ret, void> || PrimitiveParam<Ret>) && (PrimitiveParam<Args> && ...);
+
+	template <typename T>
+	auto readPrimitive(lua_State* ls, int idx, T& dest) -> bool {	// [-0, +0], mirrors the traits of T
+		if constexpr (std::same_as<T, bool>) {
+			if (!lua_isboolean(ls, idx)) {
+				return false;
+			}
+			dest = lua_toboolean(ls, idx);
+		}
+		else if constexpr (std::integral<T>) {
+			if (!lua_isinteger(ls, idx)) {
+				return false;
+			}
+			dest = static_cast<T>(lua_tointeger(ls, idx));
+		}
+		else if constexpr (std::floating_point<T>) {
+			auto isNum = 0;
+			dest = static_cast<T>(lua_tonumberx(ls, idx, &isNum));
+			return isNum;
+		}
+		else {
+			if (lua_type(ls, idx) != LUA_TSTRING) {
+				return false;
+			}
+			auto len = size_t{};
+			auto* str = lua_tolstring(ls, idx, &len);
+			dest = T(str, len);
+		}
+		return true;
 	}
-	template <typename Ret, typename Class, typename... Args>
-	auto tryToCall(lua_State* ls, Ret(Class::*f)(Args...)) {
-		return tryToCallRaw<Ret(Class::*)(Args...), Ret, Class&, Args...>(ls, f);
+	template <typename T>
+	void readPrimitiveTrusted(lua_State* ls, int idx, T& dest) {	// [-0, +0], like 'readPrimitive', but without validation
+		if constexpr (std::same_as<T, bool>) {
+			dest = lua_toboolean(ls, idx);
+		}
+		else if constexpr (std::integral<T>) {
+			dest = static_cast<T>(lua_tointeger(ls, idx));
+		}
+		else if constexpr (std::floating_point<T>) {
+			dest = static_cast<T>(lua_tonumber(ls, idx));
+		}
+		else {
+			auto len = size_t{};
+			auto* str = lua_tolstring(ls, idx, &len);
+			dest = str ? T(str, len) : T();
+		}
 	}
-	template <typename Ret, typename Class, typename... Args>
-	auto tryToCall(lua_State* ls, Ret(Class::* f)(Args...) const) {
-		return tryToCallRaw<Ret(Class::*)(Args...) const, Ret, const Class&, Args...>(ls, f);
+	template <typename T>
+	void pushPrimitive(lua_State* ls, const T& val) {	// [-0, +1]
+		if constexpr (std::same_as<T, bool>)			lua_pushboolean(ls, val);
+		else if constexpr (std::integral<T>)			lua_pushinteger(ls, val);
+		else if constexpr (std::floating_point<T>)		lua_pushnumber(ls, val);
+		else											lua_pushlstring(ls, val.data(), val.size());
+	}
+
+	template <typename Ret, typename Invoc, typename... Ts>
+	void callWithPrimitives(lua_State* ls, const Invoc& f, std::tuple<Ts...>& args) {		// [-0, +0 or +1, m]
+		if constexpr (std::same_as<Ret, void>) {
+			std::apply([&](auto&... arg) { std::invoke(f, arg...); }, args);
+		}
+		else {
+			pushPrimitive<std::decay_t<Ret>>(ls, std::apply([&](auto&... arg) { return std::invoke(f, arg...); }, args));
+		}
+	}
+
+	// A fast path for invocables with a PrimitiveSignature. Reads the args straight from the lua stack, calls, and pushes the result.
+	// Returns false (having pushed nothing) if any of the args isn't directly readable - the caller shall then fall back
+	// to 'tryToCallRaw', which also handles baked args and produces the appropriate error message.
+	template <typename Invoc, typename Ret, typename... Args>
+		requires PrimitiveSignature<Ret, Args...>
+	auto tryToCallPrimitive(lua_State* ls, const Invoc& f) -> bool {		// [-0, +0 or +1, m]
+		if (lua_gettop(ls) != sizeof...(Args)) {
+			return false;
+		}
+
+		auto args = std::tuple<std::decay_t<Args>...>{};
+		auto didReadAll = [&]<int... indices>(std::integer_sequence<int, indices...>) {
+			return (readPrimitive(ls, indices + 1, get<indices>(args)) && ...);
+		}(std::make_integer_sequence<int, sizeof...(Args)>{});
+		if (!didReadAll) {
+			return false;
+		}
+
+		callWithPrimitives<Ret>(ls, f, args);
+		return true;
+	}
+	// Same as above, but the args aren't validated - only counted, since reading past the stack top isn't allowed.
+	// Returns false (having pushed nothing) if there are too few args. Excess args are ignored.
+	template <typename Invoc, typename Ret, typename... Args>
+		requires PrimitiveSignature<Ret, Args...>
+	auto callPrimitiveTrusted(lua_State* ls, const Invoc& f) -> bool {		// [-0, +0 or +1, m]
+		if (lua_gettop(ls) < int(sizeof...(Args))) {
+			return false;
+		}
+		lua_settop(ls, sizeof...(Args));
+
+		auto args = std::tuple<std::decay_t<Args>...>{};
+		[&]<int... indices>(std::integer_sequence<int, indices...>) {
+			(readPrimitiveTrusted(ls, indices + 1, get<indices>(args)), ...);
+		}(std::make_integer_sequence<int, sizeof...(Args)>{});
+
+		callWithPrimitives<Ret>(ls, f, args);
+		return true;
+	}
+
+	// Decides whether a call of a trusted binding shall be validated (see LUASTRAP_VERIFY_TRUSTED_EVERY)
+	inline auto shouldVerifyTrustedCall() -> bool {
+		if constexpr (LUASTRAP_VERIFY_TRUSTED_EVERY == 0) {
+			return false;
+		}
+		else {
+			thread_local auto callCount = 0u;
+			return ++callCount % LUASTRAP_VERIFY_TRUSTED_EVERY == 0;
+		}
+	}
+
+	template <typename Ret, typename... Args, typename Memo>
+	auto tryToCall(lua_State* ls, Ret(*f)(Args...), Memo& memo) {
+		return tryToCallRaw<Ret(*)(Args...), Ret, Args...>(ls, f, memo);
+	}
+	template <typename Ret, typename Class, typename... Args, typename Memo>
+	auto tryToCall(lua_State* ls, Ret(Class::*f)(Args...), Memo& memo) {
+		return tryToCallRaw<Ret(Class::*)(Args...), Ret, Class&, Args...>(ls, f, memo);
+	}
+	template <typename Ret, typename Class, typename... Args, typename Memo>
+	auto tryToCall(lua_State* ls, Ret(Class::* f)(Args...) const, Memo& memo) {
+		return tryToCallRaw<Ret(Class::*)(Args...) const, Ret, const Class&, Args...>(ls, f, memo);
 	}
 	struct TryToCallSuccessivelyResult {
 		bool didAnySucceed = false;
@@ -134,18 +370,78 @@ namespace LuaStrap {
 		bool doesReturnAnything = false;
 		TryToCallResult mostRecentAttempt;
 	};
-	template <typename... Fs>
-	auto tryToCallSuccessively(lua_State* ls, Fs... fs) -> TryToCallSuccessivelyResult {
+	template <typename Memo, typename... Fs>
+	auto tryToCallSuccessively(lua_State* ls, Memo& memo, Fs... fs) -> TryToCallSuccessivelyResult {
 		auto res = TryToCallSuccessivelyResult{};
 		res.didAnySucceed = ((
 			res.doesReturnAnything = returnsAnything(fs),
-			res.mostRecentAttempt = tryToCall(ls, fs),
-			res.mostRecentAttempt.errMsg == ""
+			res.mostRecentAttempt = tryToCall(ls, fs, memo),
+			!res.mostRecentAttempt.error
 		) || ...);
 
 		return res;
 	}
 
+	// Identifies the "shape" of the args at lua stack positions 1 to n - their count, their lua types, the type IDs
+	// of LuaStrap userdata, and whether strings are convertible to numbers. Never 0.
+	auto argumentSignature(lua_State* ls) -> std::uint64_t;	// [-0, +0]
+
+	// The body of a bound function - calls a c++ invocable (of format [-0, +n, m]) with the args on the lua stack,
+	// and returns the number of results (as a lua_CFunction does). Raises a lua error on failure.
+	// If 'isTrusted', invocables with a PrimitiveSignature skip validating their args (see 'pushTrustedFunc').
+	template <typename Invoc, typename Ret, typename... Args, bool isTrusted = false>
+		requires std::invocable<Invoc, Args...>
+	auto callFromLuaRaw(lua_State* ls, const Invoc& f, std::bool_constant<isTrusted> = {}) -> int {
+		if constexpr (isTrusted && PrimitiveSignature<Ret, Args...>) {
+			if (!shouldVerifyTrustedCall() && callPrimitiveTrusted<Invoc, Ret, Args...>(ls, f)) {
+				return int{ !std::same_as<Ret, void> };
+			}
+		}
+		if constexpr (PrimitiveSignature<Ret, Args...>) {
+			if (tryToCallPrimitive<Invoc, Ret, Args...>(ls, f)) {
+				return int{ !std::same_as<Ret, void> };
+			}
+		}
+		auto callRes = tryToCallRaw<Invoc, Ret, Args...>(ls, f);
+
+		if (!callRes.error) {
+			return int{ !std::same_as<Ret, void> };
+		}
+		else {
+			return raiseCallError(ls, callRes.error);
+		}
+
+		// Reading the args may have left something on the lua stack.
+		// That will be automatically cleaned now (the lua function is ending).
+	}
+	template <typename Ret, typename... Args, bool isTrusted = false>
+	auto callFromLua(lua_State* ls, Ret(*f)(Args...), std::bool_constant<isTrusted> trust = {}) -> int {
+		return callFromLuaRaw<decltype(f), Ret, Args...>(ls, f, trust);
+	}
+	template <typename Ret, typename Class, typename... Args, bool isTrusted = false>
+	auto callFromLua(lua_State* ls, Ret(Class::*f)(Args...), std::bool_constant<isTrusted> trust = {}) -> int {
+		return callFromLuaRaw<decltype(f), Ret, Class&, Args...>(ls, f, trust);
+	}
+	template <typename Ret, typename Class, typename... Args, bool isTrusted = false>
+	auto callFromLua(lua_State* ls, Ret(Class::* f)(Args...) const, std::bool_constant<isTrusted> trust = {}) -> int {
+		return callFromLuaRaw<decltype(f), Ret, const Class&, Args...>(ls, f, trust);
+	}
+	template <typename... Fs>
+	auto callOverloadedFromLua(lua_State* ls, Fs... fs) -> int {
+		auto callResult = [&] {
+			// (the memo must be gone by the time a lua error is raised)
+			auto memo = ArgMemoFor<Fs...>{};
+			return tryToCallSuccessively(ls, memo, fs...);
+		}();
+
+		if (callResult.didAnySucceed) {
+			return int{ callResult.doesReturnAnything };
+		}
+		else {
+			return raiseCallError(ls, { CallErrorCode::noMatchingOverload });
+		}
+	}
+
 	// Wraps a c++ invocable (of format [-0, +n, m]) such that it can be called from lua, and pushes it on stack top.
 	template <typename Invoc, typename Ret, typename... Args>
 		requires std::invocable<Invoc, Args...>
@@ -154,18 +450,7 @@ namespace LuaStrap {
 		new (lua_newuserdata(ls, sizeof(Invoc))) Invoc{ f };
 		lua_pushcclosure(ls, [](lua_State* ls) {
 			auto invoc = *(Invoc*)lua_touserdata(ls, lua_upvalueindex(1));
-			auto callRes = tryToCallRaw<Invoc, Ret, Args...>(ls, invoc);
-
-			if (callRes.errMsg == "") {
-				return int{ !std::same_as<Ret, void> };
-			}
-			else {
-				lua_checkstack(ls, 1);
-				return luaL_error(ls, callRes.errMsg.c_str());
-			}
-
-			// Reading the args may have left something on the lua stack.
-			// That will be automatically cleaned now (the lua function is ending).
+			return callFromLuaRaw<Invoc, Ret, Args...>(ls, invoc);
 		}, 1);
 	}
 
@@ -188,22 +473,49 @@ namespace LuaStrap {
 		new (lua_newuserdata(ls, sizeof(FuncPtrPack))) FuncPtrPack{ fs... };
 		lua_pushcclosure(ls, [](lua_State* ls) {
 			auto fs = *(FuncPtrPack*)lua_touserdata(ls, lua_upvalueindex(1));
-
-			auto callResult = std::apply(
-				[ls]<typename... Fs>(Fs... fs) { return tryToCallSuccessively(ls, fs...); },
+			return std::apply(
+				[ls]<typename... Fs>(Fs... fs) { return callOverloadedFromLua(ls, fs...); },
 				fs
 			);
+		}, 1);
+	}
 
-			if (callResult.didAnySucceed) {
-				return int{ callResult.doesReturnAnything };
-			}
-			else {
-				lua_checkstack(ls, 1);
-				return luaL_error(ls, "None of the overloads are compatible with the given arguments.");
-			}
+	// Bound functions for targets known at compile time. These are plain lua_CFunctions, without upvalues.
+	template <auto f>
+	auto boundFunc(lua_State* ls) -> int {
+		return callFromLua(ls, f);
+	}
+	template <auto... fs>
+	auto boundOverloadedFunc(lua_State* ls) -> int {
+		return callOverloadedFromLua(ls, fs...);
+	}
+	template <auto f>
+	auto boundTrustedFunc(lua_State* ls) -> int {
+		return callFromLua(ls, f, std::true_type{});
+	}
 
-			// Reading the args may have left something on the lua stack.
-			// That will be automatically cleaned now (the lua function is ending).
-		}, 1);
+	// Same as above, but for functions known at compile time (passed as template arguments, e.g. 'pushFunc<&f>(ls)').
+	// The pushed lua function has no upvalues - no userdatum is created per binding, the function pointer isn't fetched
+	// on every call, and the compiler is free to inline the target.
+	template <auto f>
+	void pushFunc(lua_State* ls) {		// [-0, +1]
+		lua_checkstack(ls, 1);
+		lua_pushcfunction(ls, &boundFunc<f>);
+	}
+	template <auto... fs>
+	void pushOverloadedFunc(lua_State* ls) {		// [-0, +1]
+		lua_checkstack(ls, 1);
+		lua_pushcfunction(ls, &boundOverloadedFunc<fs...>);
+	}
+
+	// Like 'pushFunc<f>', but for hot functions whose callers are known to pass valid args. If f has a PrimitiveSignature,
+	// its args are converted straight from the lua stack, without checking their lua types (e.g. a table passed for a number
+	// reads as 0, or for a string as ""). Only their count is checked - too few args go through the ordinary, validating path.
+	// Otherwise it's bound like an ordinary function.
+	// Not meant for functions exposed to untrusted scripts - see LUASTRAP_VERIFY_TRUSTED_EVERY for catching misuse.
+	template <auto f>
+	void pushTrustedFunc(lua_State* ls) {		// [-0, +1]
+		lua_checkstack(ls, 1);
+		lua_pushcfunction(ls, &boundTrustedFunc<f>);
 	}
 }
@@ -9,6 +9,8 @@
 #include <functional>
 #include <string>
 #include <algorithm>
+#include <typeinfo>
+#include <cstdint>
 
 namespace LuaStrap {
 
@@ -52,13 +54,13 @@ namespace LuaStrap {
 	// Rounds the value of 'a' to the nearest multiple of 'b' not-less than 'a'
 	template <typename I>
 	constexpr auto integerCeil(I a, I b) {
-		return a * (a / b + I(a % b != 0));
+		return b * (a / b + I(a % b != 0));
 	}
 
 	// Computes the smallest size a memory arena must be to ensure that a T object fits inside,
 	// given both the object's and the arena's alignment requirements
 	template <typename T, size_t arenaAlignment = 1>
-	constexpr auto minNeededSpace = sizeof(T) + std::max((std::size_t)0, alignof(T) - arenaAlignment);
+	constexpr auto minNeededSpace = sizeof(T) + (alignof(T) > arenaAlignment ? alignof(T) - arenaAlignment : 0);
 
 	template <typename... Ts>
 	constexpr auto largestTupleElem(std::tuple<Ts...>* = nullptr) {
@@ -72,7 +74,7 @@ namespace LuaStrap {
 
 	// An on-stack memory pool. Elements are inserted sequentially, and their addresses are remembered (but not their types).
 	// Any inserted object can have arbitrary alignment. That a new object fits, or that max object count is not exceeded, 
-	// is checked at runtime. Must be manually destructed.
+	// is checked at runtime. Must be manually destructed. Objects living elsewhere can be referred to in place of an element.
 	template <size_t maxElemCount, size_t size, size_t alignment>
 	class Pool {
 	public:
@@ -88,6 +90,7 @@ namespace LuaStrap {
 
 			auto* nextElem = new (currentAddr) NextElem{ std::forward<Args>(args)... };
 			elemPtrs[elemIndex] = currentAddr;
+			isOwned[elemIndex] = true;
 			++elemIndex;
 
 			currentAddr += sizeof(NextElem);
@@ -98,23 +101,37 @@ namespace LuaStrap {
 			return nextElem;
 		}
 
+		template <typename NextElem>
+		auto refer(NextElem* elem) -> NextElem*		// the pool won't destruct 'elem'
+		{
+			assert(elemIndex < maxElemCount);
+
+			elemPtrs[elemIndex] = static_cast<char*>(static_cast<void*>(elem));
+			isOwned[elemIndex] = false;
+			++elemIndex;
+
+			return elem;
+		}
+
 		template <typename... ElemTypes>
 		void destruct() {
 			// can't provide a normal destructor, since destruction requires knowing the types of the elems
 			assert(elemIndex == sizeof...(ElemTypes));
 			auto n = 0;
 			int dummy = (
-				std::destroy_at(static_cast<ElemTypes*>(static_cast<void*>(elemPtrs[n++]))),
+				(isOwned[n] ? std::destroy_at(static_cast<ElemTypes*>(static_cast<void*>(elemPtrs[n]))) : void(), ++n),
 				..., 0
 			);
 		}
 
 		auto getElemPtrs() { return std::span{ elemPtrs.begin(), size_t(elemIndex) }; }
+		auto isElemOwned(int n) const { return isOwned[n]; }
 
 	private:
 		alignas(alignment) char pool[size];
 		char* currentAddr = pool;
 		std::array<char*, maxElemCount> elemPtrs;
+		std::array<bool, maxElemCount> isOwned;
 		int elemIndex = 0;
 	};
 
@@ -158,8 +175,16 @@ namespace LuaStrap {
 	using UnwrapTuple = std::remove_pointer_t<std::decay_t<decltype(unwrapTupleHelper<Target>((Tuple*)nullptr))>>;
 		// ^ names the type Target<TupleElem0, TupleElem1, ...>
 
+	// The position of the first T among Ts (or sizeof...(Ts) if there's none)
+	template <typename T, typename... Ts>
+	constexpr auto indexOfType(std::tuple<Ts...>* = nullptr) -> size_t {
+		auto idx = size_t{ 0 };
+		auto dummy = ((std::same_as<T, Ts> || (++idx, false)) || ...);
+		return idx;
+	}
+
 	template <typename Target, int... Indices>
-	auto unwrapIntegerSequence(std::integer_sequence<int, Indices...>) {
+	constexpr auto unwrapIntegerSequence(std::integer_sequence<int, Indices...>) {
 		return Target{ Indices... };
 	}
 
@@ -276,62 +301,41 @@ namespace LuaStrap {
 	using PackIfNeccessary = std::remove_pointer_t<std::invoke_result_t<decltype(retTypePackHelper<Ts...>)>>;
 
 	// ~ Errors ~
-	inline auto failedToEmplaceError(std::string_view typeName) {
-		using namespace std::string_literals;
-		auto err = "An argument which is taken by mutable reference must have 'emplace' defined in its LuaStrap type traits.\nArgument type: "s;
-		err += typeName;
-		err += "\nAlternatively, pass the argument as baked data, not as lua data.\n";
-		return err;
-	}
-	inline auto wrongArgumentCountError(int minArgCount, int maxArgCount, int argCount) {
-		using namespace std::string_literals;
-		if (minArgCount == maxArgCount) {
-			auto err = "Wrong number of arguments. Expected "s;
-			err += std::to_string(minArgCount);
-			err += ", got ";
-			err += std::to_string(argCount);
-			err += ".";
-			return err;
-		}
-		else {
-			auto err = "Wrong number of arguments. Expected between "s;
-			err += std::to_string(minArgCount);
-			err += " and ";
-			err += std::to_string(maxArgCount);
-			err += ", got ";
-			err += std::to_string(argCount);
-			err += ".";
-			return err;
+
+	// Why a call of a bound function failed. Most failures get recovered from (by another overload or builder
+	// alternative), so a CallError is just a code plus some context - no allocations. The message is only produced
+	// (see 'pushCallErrorMessage') once the error actually gets raised.
+	enum class CallErrorCode : std::uint8_t {
+		none,
+		wrongArgumentCount,			// values = { min count, max count, actual count }
+		failedToReadArgument,		// values[0] = lua idx of the argument
+		failedToEmplace,			// types[0] = the argument's type
+		noMatchingOverload,
+		noMatchingBulkOverload,		// types = the args built so far, argOrder = their lua positions (0 based)
+		noMatchingPartialBulkOverload,	// same as above
+		wrongArgumentFormat,		// values = { lua idx of the argument, its lua type }, types[0] = the builder
+	};
+	struct CallError {
+		CallErrorCode code = CallErrorCode::none;
+		int values[3] = {};
+		const std::type_info* const* types = nullptr;
+		int typeCount = 0;
+		const int* argOrder = nullptr;
+
+		explicit operator bool() const {	// true if there is an error
+			return code != CallErrorCode::none;
 		}
+	};
+	template <typename... Ts>
+	auto typeInfos() -> const std::type_info* const* {
+		static const std::type_info* const infos[] = { &typeid(Ts)..., nullptr };
+		return infos;
 	}
-	template <typename... Args>
-	auto noMatchingOverloadError(lua_State* ls, int* argOrder, std::string_view msg) {
-		using namespace std::string_literals;
-		auto argOrderPtr = argOrder;
-		auto lines = std::array<std::pair<int, const char*>, sizeof...(Args)> {
-			std::pair{ *(argOrderPtr++) + 1, typeid(Args).name() }...
-		};
 
-		std::sort(lines.begin(), lines.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+	void pushCallErrorMessage(lua_State* ls, const CallError& err);		// [-0, +1, m]
+	auto raiseCallError(lua_State* ls, const CallError& err) -> int;	// [-0, +0, v], prefixes the message with the location, like luaL_error
+		// ^ callers must make sure that no c++ objects with non-trivial destructors are alive in their scope (lua_error may longjmp)
 
-		auto errStr = std::string{ msg } + "\n";
-		for (const auto& errorArg : lines) {
-			errStr += "#";
-			errStr += std::to_string(errorArg.first);
-			errStr += " ";
-			errStr += errorArg.second;
-			errStr += "\n";
-		}
-		return errStr;
-	}
-	template <typename Builder>
-	auto failedToReadError(lua_State* ls, int argLuaIdx) {
-		auto errStr = std::string{ "Wrong format of argument #" } + std::to_string(argLuaIdx) +
-			"\nBuilder: " + typeid(Builder).name() +
-			"\nArgument type: " + lua_typename(ls, lua_type(ls, argLuaIdx)) +
-			"\n";
-		return errStr;
-	}
 	inline auto stackFuncWrongReturnCount(int expected, int got) {
 		using namespace std::string_literals;
 		auto errStr = "Function referred to by 'StackFunc' returned the wrong number of arguments. Expected "s;
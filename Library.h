@@ -0,0 +1,72 @@
+#pragma once
+#include "FuncBinding.h"
+#include "GenericFuncBinding.h"
+#include <array>
+#include <span>
+
+namespace LuaStrap {
+	// A named lua function, to be published as part of a Library. Made at compile time by 'func', 'overloadedFunc', 'trustedFunc',
+	// 'bulkFunc' or 'bulkMapFunc'.
+	struct LibraryEntry {
+		const char* name;
+		lua_CFunction func;
+	};
+
+	template <auto f>
+	constexpr auto func(const char* name) -> LibraryEntry {						// like 'pushFunc<f>'
+		return { name, &boundFunc<f> };
+	}
+	template <auto... fs>
+	constexpr auto overloadedFunc(const char* name) -> LibraryEntry {			// like 'pushOverloadedFunc<fs...>'
+		return { name, &boundOverloadedFunc<fs...> };
+	}
+	template <auto f>
+	constexpr auto trustedFunc(const char* name) -> LibraryEntry {				// like 'pushTrustedFunc<f>'
+		return { name, &boundTrustedFunc<f> };
+	}
+	template <typename... Builders, typename Exec>
+	constexpr auto bulkFunc(const char* name, Exec) -> LibraryEntry {			// like 'pushBulkFunc<Builders...>'
+		return { name, &boundBulkFunc<Exec, Builders...> };
+	}
+	template <typename... Builders, typename Exec>
+	constexpr auto bulkMapFunc(const char* name, Exec) -> LibraryEntry {		// like 'pushBulkMapFunc<Builders...>'
+		return { name, &boundBulkMapFunc<Exec, Builders...> };
+	}
+
+	// A set of functions described at compile time, e.g.
+	//	constexpr auto mathLib = LuaStrap::Library{
+	//		LuaStrap::func<&average>("average"),
+	//		LuaStrap::overloadedFunc<&plusReal, &plusComplex>("plus")
+	//	};
+	// Publishing it creates no userdata and no closures - just one table entry per function.
+	template <size_t n>
+	struct Library {
+		std::array<LibraryEntry, n> entries;
+	};
+	template <typename... Entries>
+	Library(Entries...) -> Library<sizeof...(Entries)>;
+
+	enum class PublishMode {
+		eager,	// all functions are put into the target table right away
+		lazy	// the target table gets an '__index' metamethod, which puts each function into the table once it's first accessed
+				// (so only the functions a script actually uses cost anything). The entries are referred to, not copied, so they
+				// must outlive the lua_State - in practice, they shall have static storage duration (e.g. a constexpr Library).
+				// Unaccessed functions aren't visible to 'pairs' or 'rawget'. If the target table already has an '__index'
+				// metamethod, the library is published eagerly instead.
+	};
+
+	void publishLibrary(lua_State* ls, std::span<const LibraryEntry> entries, PublishMode mode = PublishMode::eager);	// [-0, +0, m], -1 = target table
+		// ^ in lazy mode, 'entries' must have static storage duration (see PublishMode::lazy)
+	void pushLibrary(lua_State* ls, std::span<const LibraryEntry> entries);		// [-0, +1, m], a new table pre-sized for the entries
+
+	template <size_t n>
+	void publishLibrary(lua_State* ls, const Library<n>& lib, PublishMode mode = PublishMode::eager) {	// [-0, +0, m], -1 = target table
+		publishLibrary(ls, std::span<const LibraryEntry>{ lib.entries }, mode);
+	}
+	template <size_t n>
+	void publishLibrary(lua_State* ls, const Library<n>&& lib, PublishMode mode = PublishMode::eager) = delete;	// (a temporary might be published lazily)
+	template <size_t n>
+	void pushLibrary(lua_State* ls, const Library<n>& lib) {		// [-0, +1, m]
+		pushLibrary(ls, std::span<const LibraryEntry>{ lib.entries });
+	}
+}
@@ -248,7 +248,7 @@ namespace LuaStrap {
 		using difference_type = lua_Integer;
 		using value_type = StackArrayElem;
 
-		static std::deque<StackArrayElem> nonOwners;
+		static thread_local std::deque<StackArrayElem> nonOwners;
 		static void clearGarbage() { nonOwners.clear(); }
 
 		lua_State* ls;
@@ -329,6 +329,7 @@ namespace LuaStrap {
 	};
 	template <typename... RetTypes>
 	struct Traits<StackFunc<RetTypes...>> {
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TFUNCTION);
 		static auto read(lua_State* ls, int idx) -> std::optional<StackFunc<RetTypes...>> {		// [-0, +0]
 			if (!lua_isfunction(ls, idx)) {
 				lua_pop(ls, 1);
@@ -343,6 +344,7 @@ namespace LuaStrap {
 	template <>
 	struct Traits<ArrayIterator> {
 		// raw { [1] = (table)theArray, [2] = (integer)key }
+		static constexpr LuaTypeMask luaTypes = luaTypeBit(LUA_TTABLE);
 		static auto read(lua_State* ls, int idx) -> std::optional<ArrayIterator> {		// [-0, +1]
 			if (!lua_istable(ls, idx)) {
 				return std::nullopt;
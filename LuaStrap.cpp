@@ -1,6 +1,9 @@
 #include "LuaStrap.h"
 #include <algorithm>
 #include <numeric>
+#include <atomic>
+#include <cstring>
+#include <bit>
 
 namespace LuaStrap {
 
@@ -8,82 +11,223 @@ std::function<void(std::string_view)> edgeCaseErrorHandler = [](std::string_view
 	assert(false);
 	std::terminate();
 };
-std::deque<StackArrayElem> ArrayIterator::nonOwners;
+thread_local std::deque<StackArrayElem> ArrayIterator::nonOwners;
 
 void clearLuaRepresObjGarbage() {
 	ArrayIterator::clearGarbage();
 }
 
+void pushCallErrorMessage(lua_State* ls, const CallError& err) {
+	lua_checkstack(ls, 3);
+	switch (err.code) {
+		case CallErrorCode::none:
+			lua_pushliteral(ls, "No error.");
+			break;
+		case CallErrorCode::wrongArgumentCount:
+			if (err.values[0] == err.values[1]) {
+				lua_pushfstring(ls, "Wrong number of arguments. Expected %d, got %d.", err.values[0], err.values[2]);
+			}
+			else {
+				lua_pushfstring(ls, "Wrong number of arguments. Expected between %d and %d, got %d.", err.values[0], err.values[1], err.values[2]);
+			}
+			break;
+		case CallErrorCode::failedToReadArgument:
+			lua_pushfstring(ls, "Failed reading argument #%d.", err.values[0]);
+			break;
+		case CallErrorCode::failedToEmplace:
+			lua_pushfstring(ls,
+				"An argument which is taken by mutable reference must have 'emplace' defined in its LuaStrap type traits.\nArgument type: %s"
+				"\nAlternatively, pass the argument as baked data, not as lua data.\n",
+				err.types[0]->name()
+			);
+			break;
+		case CallErrorCode::noMatchingOverload:
+			lua_pushliteral(ls, "None of the overloads are compatible with the given arguments.");
+			break;
+		case CallErrorCode::noMatchingBulkOverload:
+		case CallErrorCode::noMatchingPartialBulkOverload: {
+			lua_pushstring(ls, err.code == CallErrorCode::noMatchingBulkOverload ?
+				"No overload available for the given arguments:\n" :
+				"No overload available for the given partial list of arguments:\n"
+			);
+			// List the args by their lua position
+			auto maxPos = -1;
+			for (auto i = 0; i < err.typeCount; ++i) {
+				maxPos = std::max(maxPos, err.argOrder[i]);
+			}
+			for (auto pos = 0; pos <= maxPos; ++pos) {
+				for (auto i = 0; i < err.typeCount; ++i) {
+					if (err.argOrder[i] == pos) {
+						lua_pushfstring(ls, "#%d %s\n", pos + 1, err.types[i]->name());
+						lua_concat(ls, 2);
+					}
+				}
+			}
+			break;
+		}
+		case CallErrorCode::wrongArgumentFormat:
+			lua_pushfstring(ls, "Wrong format of argument #%d\nBuilder: %s\nArgument type: %s\n",
+				err.values[0], err.types[0]->name(), lua_typename(ls, err.values[1])
+			);
+			break;
+	}
+}
+auto raiseCallError(lua_State* ls, const CallError& err) -> int {
+	lua_checkstack(ls, 2);
+	luaL_where(ls, 1);
+	pushCallErrorMessage(ls, err);
+	lua_concat(ls, 2);
+	return lua_error(ls);
+}
+
 template <typename Dest, typename... Args>
 auto pass(Args... args) {
 	return Dest{}(args...);
 }
 
-static void refHoldingMetatable(lua_State* ls, std::map<lua_State*, int>& refsPerLs) {
-	// Metatable for userdata holding a reference to lua registry.
-	// Is created once per lua_State, then only fetched.
+static auto typeIdCounter = std::atomic<int>{ indirectDataTypeId };
+auto newTypeId() -> int {
+	return ++typeIdCounter;
+}
+
+static const char typeRegistryKey = 0;	// the address of this is the registry key of the per-lua_State metatable table
 
-	auto mainThread = getMainThread(ls);
-	lua_checkstack(ls, 2);
+void fetchMetatable(lua_State* ls, int typeId, void(*build)(lua_State*)) {
+	lua_checkstack(ls, 3);
 
-	if (auto ref = refsPerLs.find(mainThread); ref == refsPerLs.end()) {
-		lua_createtable(ls, 0, 0); {
-			lua_pushcfunction(ls, [](lua_State* ls) {
-				// (userdatum)
-				auto* udata = lua_touserdata(ls, 1);
-				assert(udata != nullptr);
-				auto ref = *static_cast<int*>(udata);
-				luaL_unref(ls, LUA_REGISTRYINDEX, ref);
-				return 0;
-			});
-			lua_setfield(ls, -2, "__gc");
-		}
+	if (lua_rawgetp(ls, LUA_REGISTRYINDEX, &typeRegistryKey) == LUA_TNIL) {
+		lua_pop(ls, 1);
+		lua_createtable(ls, typeIdCounter.load(std::memory_order_relaxed), 0);
 		lua_pushvalue(ls, -1);
-		refsPerLs.emplace(mainThread, luaL_ref(ls, LUA_REGISTRYINDEX));
+		lua_rawsetp(ls, LUA_REGISTRYINDEX, &typeRegistryKey);
 	}
-	else {
-		lua_rawgeti(ls, LUA_REGISTRYINDEX, ref->second);
+	// -1 = metatable table
+
+	if (lua_rawgeti(ls, -1, typeId) == LUA_TNIL) {
+		lua_pop(ls, 1);
+		build(ls);
+		lua_pushvalue(ls, -1);
+		lua_rawseti(ls, -3, typeId);
+	}
+	lua_remove(ls, -2);
+}
+
+static void refHoldingMetatable(lua_State* ls) {
+	// Metatable for userdata holding a reference to lua registry
+	lua_createtable(ls, 0, 0); {
+		lua_pushcfunction(ls, [](lua_State* ls) {
+			// (userdatum)
+			assert(userdataHeader(ls, 1) != nullptr);
+			auto ref = *userdataPayload<int>(ls, 1);
+			luaL_unref(ls, LUA_REGISTRYINDEX, ref);
+			return 0;
+		});
+		lua_setfield(ls, -2, "__gc");
 	}
 }
 
 void PendingData::metatable(lua_State* ls) {
-	static auto refsPerLs = std::map<lua_State*, int>{};
-	refHoldingMetatable(ls, refsPerLs);
+	fetchMetatable(ls, pendingDataTypeId, &refHoldingMetatable);
 }
 void IndirectData::metatable(lua_State* ls) {
-	static auto refsPerLs = std::map<lua_State*, int>{};
-	refHoldingMetatable(ls, refsPerLs);
+	fetchMetatable(ls, indirectDataTypeId, &refHoldingMetatable);
 }
 
 auto dataDispatch(lua_State* ls, int idx) -> AnyData {
 	idx = lua_absindex(ls, idx);
-	lua_checkstack(ls, 2);
 
-	if (!lua_isuserdata(ls, idx)) {
+	if (lua_type(ls, idx) != LUA_TUSERDATA) {
 		return LuaData{ ls, idx };
 	}
 
-	auto hasMt = lua_getmetatable(ls, idx);
-	if (!hasMt) {
-		lua_pop(ls, 1);
-		return FailData{};
+	auto* header = userdataHeader(ls, idx);
+	if (!header) {
+		return FailData{};	// not created by LuaStrap
 	}
 
-	IndirectData::metatable(ls);
-	if (lua_rawequal(ls, -2, -1)) {
-		lua_pop(ls, 2);	// pop metatables
-		return IndirectData{ ls, idx };
+	switch (header->typeId) {
+		case pendingDataTypeId:		return PendingData{ ls, idx };
+		case indirectDataTypeId:	return IndirectData{ ls, idx };
+		default:					return BakedData{ ls, idx };
 	}
-	lua_pop(ls, 1);
+}
 
-	PendingData::metatable(ls);
-	if (lua_rawequal(ls, -2, -1)) {
-		lua_pop(ls, 2);	// pop metatables
-		return PendingData{ ls, idx };
+MemberNameIndex::MemberNameIndex(std::vector<std::string_view> names) : names(std::move(names)) {
+	// Seeds are tried until there are no collisions, growing the table if none of them works
+	auto memberCount = int(this->names.size());
+	for (auto slotCount = size_t{ 1 } << std::bit_width(size_t(2 * memberCount)); ; slotCount *= 2) {
+		for (seed = 0; seed < 64; ++seed) {
+			slots.assign(slotCount, -1);
+			auto isPerfect = true;
+			for (auto i = 0; i < memberCount && isPerfect; ++i) {
+				auto& slot = slots[hash(this->names[i], seed) & (slotCount - 1)];
+				if (slot == -1) {
+					slot = i;
+				}
+				else if (this->names[slot] != this->names[i]) {
+					isPerfect = false;
+				}
+			}
+			if (isPerfect) {
+				return;
+			}
+		}
+	}
+}
+
+auto LuaValueShape::probe(lua_State* ls, int idx, bool shouldProbeElems, bool shouldProbeKeys) -> LuaValueShape {
+	auto res = LuaValueShape{ lua_type(ls, idx) };
+	if (res.luaType == LUA_TTABLE) {
+		res.arrayLength = int(lua_rawlen(ls, idx));
+		lua_checkstack(ls, 2);
+		if (shouldProbeElems && res.arrayLength > 0) {
+			res.firstElemType = luaTypeBit(lua_rawgeti(ls, idx, 1));
+			lua_pop(ls, 1);
+		}
+		if (shouldProbeKeys && res.arrayLength == 0) {
+			idx = lua_absindex(ls, idx);
+			lua_pushnil(ls);
+			if (lua_next(ls, idx)) {
+				res.isKeyed = true;
+				lua_pop(ls, 2);
+			}
+		}
 	}
-	lua_pop(ls, 2); // pop metatables
+	return res;
+}
+
+auto argumentSignature(lua_State* ls) -> std::uint64_t {
+	constexpr auto prime = std::uint64_t{ 0x100000001B3 };
+	constexpr auto numericString = LUA_NUMTAGS;	// a pseudo lua type, distinct from all the real ones
+
+	auto top = lua_gettop(ls);
+	auto signature = std::uint64_t(top) + 1;
+	for (auto i = 1; i <= top; ++i) {
+		auto type = lua_type(ls, i);
+		if (type == LUA_TSTRING && lua_isnumber(ls, i)) {
+			type = numericString;
+		}
+		signature = (signature ^ std::uint64_t(type + 1)) * prime;
 
-	return BakedData{ ls, idx };
+		if (type == LUA_TUSERDATA) {
+			if (auto* header = userdataHeader(ls, i)) {
+				signature = (signature ^ std::uint64_t(header->typeId)) * prime;
+			}
+		}
+	}
+	return signature | 1;
+}
+auto argumentShapeSignature(lua_State* ls) -> std::uint64_t {
+	constexpr auto prime = std::uint64_t{ 0x100000001B3 };
+
+	auto signature = argumentSignature(ls);
+	auto top = lua_gettop(ls);
+	for (auto i = 1; i <= top; ++i) {
+		if (lua_type(ls, i) == LUA_TTABLE) {
+			signature = (signature ^ std::uint64_t(lua_rawlen(ls, i))) * prime;
+		}
+	}
+	return signature | 1;
 }
 
 void LuaData::toLuaData() const {
@@ -91,7 +235,7 @@ void LuaData::toLuaData() const {
 }
 void PendingData::toLuaData() const {
 	// -1 = pendingData
-	auto refToLuaData = static_cast<int*>(lua_touserdata(ls, 1));
+	auto refToLuaData = userdataPayload<int>(ls, 1);
 	lua_rawgeti(ls, LUA_REGISTRYINDEX, *refToLuaData);
 }
 void BakedData::toLuaData() const {
@@ -111,7 +255,7 @@ void BakedData::toLuaData() const {
 void IndirectData::toLuaData() const {
 	// -1 = indirectData
 	lua_checkstack(ls, 2);
-	auto ref = *static_cast<int*>(lua_touserdata(ls, -1));
+	auto ref = *userdataPayload<int>(ls, -1);
 	lua_rawgeti(ls, LUA_REGISTRYINDEX, ref);
 
 	BakedData{ ls, lua_gettop(ls) }.toLuaData();
@@ -146,7 +290,7 @@ void LuaData::toBakedData() const {
 		// stack: -1 = luarepres
 		lua_pushvalue(ls, -1);
 		auto luaDataStackObj = luaL_ref(ls, LUA_REGISTRYINDEX);
-		new (lua_newuserdata(ls, sizeof(int))) int{ luaDataStackObj }; {
+		newUserdata<int>(ls, pendingDataTypeId, luaDataStackObj); {
 			PendingData::metatable(ls);
 			lua_setmetatable(ls, -2);
 		}
@@ -165,8 +309,74 @@ void FailData::toBakedData() const {
 	assert(false);
 }
 
-void publishLuaStrapUtils(lua_State* ls) {
-	lua_pushcfunction(ls, [](lua_State* ls) {
+static void publishLibraryEagerly(lua_State* ls, std::span<const LibraryEntry> entries) {	// [-0, +0, m], -1 = target table
+	lua_checkstack(ls, 1);
+	for (const auto& entry : entries) {
+		lua_pushcfunction(ls, entry.func);
+		lua_setfield(ls, -2, entry.name);
+	}
+}
+static auto lazyLibraryIndex(lua_State* ls) -> int {
+	// (table, key), upvalues: (entries as light userdata, entry count)
+	if (lua_type(ls, 2) != LUA_TSTRING) {
+		lua_pushnil(ls);
+		return 1;
+	}
+
+	auto* entries = static_cast<const LibraryEntry*>(lua_touserdata(ls, lua_upvalueindex(1)));
+	auto count = lua_tointeger(ls, lua_upvalueindex(2));
+	auto* key = lua_tostring(ls, 2);
+	auto* found = std::find_if(entries, entries + count, [&](const LibraryEntry& entry) { return std::strcmp(entry.name, key) == 0; });
+	if (found == entries + count) {
+		lua_pushnil(ls);
+		return 1;
+	}
+
+	// Cache the function in the table, so that the metamethod isn't invoked for this key again
+	lua_checkstack(ls, 3);
+	lua_pushcfunction(ls, found->func);
+	lua_pushvalue(ls, 2);
+	lua_pushvalue(ls, -2);
+	lua_rawset(ls, 1);
+	return 1;
+}
+void publishLibrary(lua_State* ls, std::span<const LibraryEntry> entries, PublishMode mode) {
+	if (mode == PublishMode::eager) {
+		publishLibraryEagerly(ls, entries);
+		return;
+	}
+
+	lua_checkstack(ls, 4);
+	if (lua_getmetatable(ls, -1)) {
+		if (lua_getfield(ls, -1, "__index") != LUA_TNIL) {
+			// The table already has a way of resolving missing keys; don't interfere with it
+			lua_pop(ls, 2);
+			publishLibraryEagerly(ls, entries);
+			return;
+		}
+		lua_pop(ls, 1);
+	}
+	else {
+		lua_createtable(ls, 0, 1);
+		lua_pushvalue(ls, -1);
+		lua_setmetatable(ls, -3);
+	}
+	// -2 = target table, -1 = its metatable
+
+	lua_pushlightuserdata(ls, const_cast<LibraryEntry*>(entries.data()));
+	lua_pushinteger(ls, lua_Integer(entries.size()));
+	lua_pushcclosure(ls, lazyLibraryIndex, 2);
+	lua_setfield(ls, -2, "__index");
+	lua_pop(ls, 1);
+}
+void pushLibrary(lua_State* ls, std::span<const LibraryEntry> entries) {
+	lua_checkstack(ls, 2);
+	lua_createtable(ls, 0, int(entries.size()));
+	publishLibraryEagerly(ls, entries);
+}
+
+static constexpr auto luaStrapUtilsLibrary = Library{
+	LibraryEntry{ "unbaked", [](lua_State* ls) {
 		// (userdata)
 		if (lua_gettop(ls) == 0) {
 			return luaL_error(ls, "No arguments provided.");
@@ -174,10 +384,8 @@ void publishLuaStrapUtils(lua_State* ls) {
 		lua_settop(ls, 1);
 		dataDispatch(ls, 1).toLuaData();
 		return 1;
-	});
-	lua_setfield(ls, -2, "unbaked");
-
-	lua_pushcfunction(ls, [](lua_State* ls) {
+	} },
+	LibraryEntry{ "markedForBaking", [](lua_State* ls) {
 		// (luarepres)
 		if (lua_gettop(ls) == 0) {
 			return luaL_error(ls, "No arguments provided.");
@@ -185,528 +393,388 @@ void publishLuaStrapUtils(lua_State* ls) {
 		lua_settop(ls, 1);
 		dataDispatch(ls, 1).toBakedData();
 		return 1;
-	});
-	lua_setfield(ls, -2, "markedForBaking");
+	} }
+};
+
+void publishLuaStrapUtils(lua_State* ls, PublishMode mode) {
+	publishLibrary(ls, luaStrapUtilsLibrary, mode);
 }
 
-void publishStl(lua_State* ls) {
+// Note: Since the address of an std function shall not be taken, referring to them requires a workaround.
+// Hence the Wrapper, the 'pass' function, and the gratuitous lambdas.
 
-	// Note: Since the address of an std function shall not be taken, referring to them requires a workaround.
-	// Hence the Wrapper, the 'pass' function, and the gratuitous lambdas.
+#define Wrapper(funcName) []<typename... Args>(Args&&... args) { return funcName(std::forward<Args>(args)...); }
 
-	#define Wrapper(funcName) []<typename... Args>(Args&&... args) { return funcName(std::forward<Args>(args)...); }
+// 'pass' instantiated for a signature given as a function type, e.g. 'void(ArrayIterator, ArrayIterator)'
+template <typename Func, typename Signature>
+constexpr auto passPtr = nullptr;
+template <typename Func, typename... Args>
+constexpr auto passPtr<Func, void(Args...)> = &pass<Func, Args...>;
+
+template <typename Func, typename... Signatures>
+constexpr auto stlOverloads(const char* name) -> LibraryEntry {
+	return overloadedFunc<passPtr<Func, Signatures>...>(name);
+}
 
+static constexpr auto stlLibrary = Library{
 	// Non-modifying sequence operations
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::all_of(first, last, pred);
-	}); lua_setfield(ls, -2, "all_of");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("all_of"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::any_of(first, last, pred);
-	}); lua_setfield(ls, -2, "any_of");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("any_of"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::none_of(first, last, pred);
-	}); lua_setfield(ls, -2, "none_of");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackObj value) {
+	}>("none_of"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackObj value) {
 		return std::count(first, last, value);
-	}); lua_setfield(ls, -2, "count");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("count"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::count_if(first, last, pred);
-	}); lua_setfield(ls, -2, "count_if");
-	pushFunc(ls, +[](ArrayIterator first1, ArrayIterator last1, ArrayIterator first2, ArrayIterator last2) {
+	}>("count_if"),
+	func<+[](ArrayIterator first1, ArrayIterator last1, ArrayIterator first2, ArrayIterator last2) {
 		return std::mismatch(first1, last1, first2, last2);
-	}); lua_setfield(ls, -2, "mismatch");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackObj value) {
+	}>("mismatch"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackObj value) {
 		return std::find(first, last, value);
-	}); lua_setfield(ls, -2, "find");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("find"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::find_if(first, last, pred);
-	}); lua_setfield(ls, -2, "find_if");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("find_if"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::find_if_not(first, last, pred);
-	}); lua_setfield(ls, -2, "find_if_not");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator s_first, ArrayIterator s_last) {
+	}>("find_if_not"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator s_first, ArrayIterator s_last) {
 		return std::find_end(first, last, s_first, s_last);
-	}); lua_setfield(ls, -2, "find_end");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator s_first, ArrayIterator s_last) {
+	}>("find_end"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator s_first, ArrayIterator s_last) {
 		return std::find_first_of(first, last, s_first, s_last);
-	}); lua_setfield(ls, -2, "find_first_of");
-	{
-		using Trans = decltype(Wrapper(std::adjacent_find));
-		pushOverloadedFunc(ls,
-			&pass<Trans, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Trans, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "adjacent_find");
-	}
-	{
-		using Trans = decltype(Wrapper(std::search));
-		pushOverloadedFunc(ls,
-			&pass<Trans, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Trans, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "search");
-	}
-	{
-		using Trans = decltype(Wrapper(std::search_n));
-		pushOverloadedFunc(ls,
-			&pass<Trans, ArrayIterator, ArrayIterator, int, StackObj, StackFunc<bool>>,
-			&pass<Trans, ArrayIterator, ArrayIterator, int, StackObj>
-		); lua_setfield(ls, -2, "search_n");
-	}
+	}>("find_first_of"),
+	stlOverloads<decltype(Wrapper(std::adjacent_find)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("adjacent_find"),
+	stlOverloads<decltype(Wrapper(std::search)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("search"),
+	stlOverloads<decltype(Wrapper(std::search_n)),
+		void(ArrayIterator, ArrayIterator, int, StackObj, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, int, StackObj)
+	>("search_n"),
 
 	// Modifying sequence operations
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first) {
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first) {
 		return std::copy(first, last, d_first);
-	}); lua_setfield(ls, -2, "copy");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackFunc<bool> pred) {
+	}>("copy"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackFunc<bool> pred) {
 		return std::copy_if(first, last, d_first, pred);
-	}); lua_setfield(ls, -2, "copy_if");
-	pushFunc(ls, +[](ArrayIterator first, int count, ArrayIterator result) {
+	}>("copy_if"),
+	func<+[](ArrayIterator first, int count, ArrayIterator result) {
 		return std::copy_n(first, count, result);
-	}); lua_setfield(ls, -2, "copy_n");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_last) {
+	}>("copy_n"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_last) {
 		return std::copy_backward(first, last, d_last);
-	}); lua_setfield(ls, -2, "copy_backward");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackObj value) {
+	}>("copy_backward"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackObj value) {
 		return std::fill(first, last, value);
-	}); lua_setfield(ls, -2, "fill");
-	pushFunc(ls, +[](ArrayIterator first, int count, StackObj value) {
+	}>("fill"),
+	func<+[](ArrayIterator first, int count, StackObj value) {
 		return std::fill_n(first, count, value);
-	}); lua_setfield(ls, -2, "fill_n");
-
-	{
-		using Trans = decltype(Wrapper(std::transform));
-		pushOverloadedFunc(ls,
-			&pass<Trans, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>>,
-			&pass<Trans, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>>
-		); lua_setfield(ls, -2, "transform");
-	}
+	}>("fill_n"),
 
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<StackObj> gen) {
+	stlOverloads<decltype(Wrapper(std::transform)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>)
+	>("transform"),
+
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<StackObj> gen) {
 		return std::generate(first, last, gen);
-	}); lua_setfield(ls, -2, "generate");
-	pushFunc(ls, +[](ArrayIterator first, int count, StackFunc<StackObj> gen) {
+	}>("generate"),
+	func<+[](ArrayIterator first, int count, StackFunc<StackObj> gen) {
 		return std::generate_n(first, count, gen);
-	}); lua_setfield(ls, -2, "generate_n");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackObj val) {
+	}>("generate_n"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackObj val) {
 		return std::remove(first, last, val);
-	}); lua_setfield(ls, -2, "remove");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("remove"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::remove_if(first, last, pred);
-	}); lua_setfield(ls, -2, "remove_if");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackObj val) {
+	}>("remove_if"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackObj val) {
 		return std::remove_copy(first, last, d_first, val);
-	}); lua_setfield(ls, -2, "remove_copy");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackFunc<bool> pred) {
+	}>("remove_copy"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackFunc<bool> pred) {
 		return std::remove_copy_if(first, last, d_first, pred);
-	}); lua_setfield(ls, -2, "remove_copy_if");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackObj old_value, StackObj new_value) {
+	}>("remove_copy_if"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackObj old_value, StackObj new_value) {
 		return std::replace(first, last, old_value, new_value);
-	}); lua_setfield(ls, -2, "replace");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred, StackObj new_value) {
+	}>("replace"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred, StackObj new_value) {
 		return std::replace_if(first, last, pred, new_value);
-	}); lua_setfield(ls, -2, "replace_if");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackObj old_value, StackObj new_value) {
+	}>("replace_if"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackObj old_value, StackObj new_value) {
 		return std::replace_copy(first, last, d_first, old_value, new_value);
-	}); lua_setfield(ls, -2, "replace_copy");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackFunc<bool> pred, StackObj new_value) {
+	}>("replace_copy"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first, StackFunc<bool> pred, StackObj new_value) {
 		return std::replace_copy_if(first, last, d_first, pred, new_value);
-	}); lua_setfield(ls, -2, "replace_copy_if");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator first2) {
+	}>("replace_copy_if"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator first2) {
 		return std::swap_ranges(first, last, first2);
-	}); lua_setfield(ls, -2, "swap_ranges");
-	pushFunc(ls, +[](ArrayIterator a, ArrayIterator b) {
+	}>("swap_ranges"),
+	func<+[](ArrayIterator a, ArrayIterator b) {
 		return std::iter_swap(a, b);
-	}); lua_setfield(ls, -2, "iter_swap");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last) {
+	}>("iter_swap"),
+	func<+[](ArrayIterator first, ArrayIterator last) {
 		return std::reverse(first, last);
-	}); lua_setfield(ls, -2, "reverse");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first) {
+	}>("reverse"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator d_first) {
 		return std::reverse_copy(first, last, d_first);
-	}); lua_setfield(ls, -2, "reverse_copy");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator middle, ArrayIterator last) {
+	}>("reverse_copy"),
+	func<+[](ArrayIterator first, ArrayIterator middle, ArrayIterator last) {
 		return std::rotate(first, middle, last);
-	}); lua_setfield(ls, -2, "rotate");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator n_first, ArrayIterator last, ArrayIterator d_first) {
+	}>("rotate"),
+	func<+[](ArrayIterator first, ArrayIterator n_first, ArrayIterator last, ArrayIterator d_first) {
 		return std::rotate_copy(first, n_first, last, d_first);
-	}); lua_setfield(ls, -2, "rotate_copy");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, int n) {
+	}>("rotate_copy"),
+	func<+[](ArrayIterator first, ArrayIterator last, int n) {
 		return std::shift_left(first, last, n);
-	}); lua_setfield(ls, -2, "shift_left");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, int n) {
+	}>("shift_left"),
+	func<+[](ArrayIterator first, ArrayIterator last, int n) {
 		return std::shift_right(first, last, n);
-	}); lua_setfield(ls, -2, "shift_right");
-	{
-		using Func = decltype(Wrapper(std::unique));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "unique");
-	}
-	{
-		using Func = decltype(Wrapper(std::unique_copy));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "unique_copy");
-	}
+	}>("shift_right"),
+	stlOverloads<decltype(Wrapper(std::unique)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("unique"),
+	stlOverloads<decltype(Wrapper(std::unique_copy)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("unique_copy"),
 
 	// Partitioning operations
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::is_partitioned(first, last, pred);
-	}); lua_setfield(ls, -2, "is_partitioned");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("is_partitioned"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::partition(first, last, pred);
-	}); lua_setfield(ls, -2, "partition");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, ArrayIterator first_true, ArrayIterator first_false, StackFunc<bool> pred) {
+	}>("partition"),
+	func<+[](ArrayIterator first, ArrayIterator last, ArrayIterator first_true, ArrayIterator first_false, StackFunc<bool> pred) {
 		return std::partition_copy(first, last, first_true, first_false, pred);
-	}); lua_setfield(ls, -2, "partition_copy");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("partition_copy"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::stable_partition(first, last, pred);
-	}); lua_setfield(ls, -2, "stable_partition");
-	pushFunc(ls, +[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
+	}>("stable_partition"),
+	func<+[](ArrayIterator first, ArrayIterator last, StackFunc<bool> pred) {
 		return std::partition_point(first, last, pred);
-	}); lua_setfield(ls, -2, "partition_point");
+	}>("partition_point"),
 
 	// Sorting operations
-	{
-		using Func = decltype(Wrapper(std::is_sorted));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "is_sorted");
-	}
-	{
-		using Func = decltype(Wrapper(std::is_sorted_until));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "is_sorted_until");
-	}
-	{
-		using Func = decltype(Wrapper(std::sort));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "sort");
-	}
-	{
-		using Func = decltype(Wrapper(std::partial_sort));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "partial_sort");
-	}
-	{
-		using Func = decltype(Wrapper(std::partial_sort_copy));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "partial_sort_copy");
-	}
-	{
-		using Func = decltype(Wrapper(std::stable_sort));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "stable_sort");
-	}
-	{
-		using Func = decltype(Wrapper(std::nth_element));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "nth_element");
-	}
+	stlOverloads<decltype(Wrapper(std::is_sorted)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("is_sorted"),
+	stlOverloads<decltype(Wrapper(std::is_sorted_until)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("is_sorted_until"),
+	stlOverloads<decltype(Wrapper(std::sort)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("sort"),
+	stlOverloads<decltype(Wrapper(std::partial_sort)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("partial_sort"),
+	stlOverloads<decltype(Wrapper(std::partial_sort_copy)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("partial_sort_copy"),
+	stlOverloads<decltype(Wrapper(std::stable_sort)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("stable_sort"),
+	stlOverloads<decltype(Wrapper(std::nth_element)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("nth_element"),
 
 	// Binary search operations (on sorted ranges)
-	{
-		using Func = decltype(Wrapper(std::lower_bound));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "lower_bound");
-	}
-	{
-		using Func = decltype(Wrapper(std::upper_bound));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "upper_bound");
-	}
-	{
-		using Func = decltype(Wrapper(std::binary_search));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "binary_search");
-	}
-	{
-		using Func = decltype(Wrapper(std::equal_range));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "equal_range");
-	}
+	stlOverloads<decltype(Wrapper(std::lower_bound)),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, StackObj)
+	>("lower_bound"),
+	stlOverloads<decltype(Wrapper(std::upper_bound)),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, StackObj)
+	>("upper_bound"),
+	stlOverloads<decltype(Wrapper(std::binary_search)),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, StackObj)
+	>("binary_search"),
+	stlOverloads<decltype(Wrapper(std::equal_range)),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, StackObj)
+	>("equal_range"),
 
 	// Other operations on sorted ranges
-	{
-		using Func = decltype(Wrapper(std::merge));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "merge");
-	}
-	{
-		using Func = decltype(Wrapper(std::inplace_merge));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "inplace_merge");
-	}
+	stlOverloads<decltype(Wrapper(std::merge)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("merge"),
+	stlOverloads<decltype(Wrapper(std::inplace_merge)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("inplace_merge"),
 
 	// Set operations (on sorted ranges)
-	{
-		using Func = decltype(Wrapper(std::includes));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "includes");
-	}
-	{
-		using Func = decltype(Wrapper(std::set_difference));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "set_difference");
-	}
-	{
-		using Func = decltype(Wrapper(std::set_intersection));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "set_intersection");
-	}
-	{
-		using Func = decltype(Wrapper(std::set_symmetric_difference));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "set_symmetric_difference");
-	}
-	{
-		using Func = decltype(Wrapper(std::set_union));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "set_union");
-	}
+	stlOverloads<decltype(Wrapper(std::includes)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("includes"),
+	stlOverloads<decltype(Wrapper(std::set_difference)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("set_difference"),
+	stlOverloads<decltype(Wrapper(std::set_intersection)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("set_intersection"),
+	stlOverloads<decltype(Wrapper(std::set_symmetric_difference)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("set_symmetric_difference"),
+	stlOverloads<decltype(Wrapper(std::set_union)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("set_union"),
 
 	// Heap operations
-	{
-		using Func = decltype(Wrapper(std::is_heap));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "is_heap");
-	}
-	{
-		using Func = decltype(Wrapper(std::is_heap_until));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "is_heap_until");
-	}
-	{
-		using Func = decltype(Wrapper(std::make_heap));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "make_heap");
-	}
-	{
-		using Func = decltype(Wrapper(std::push_heap));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "push_heap");
-	}
-	{
-		using Func = decltype(Wrapper(std::pop_heap));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "pop_heap");
-	}
-	{
-		using Func = decltype(Wrapper(std::sort_heap));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "sort_heap");
-	}
+	stlOverloads<decltype(Wrapper(std::is_heap)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("is_heap"),
+	stlOverloads<decltype(Wrapper(std::is_heap_until)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("is_heap_until"),
+	stlOverloads<decltype(Wrapper(std::make_heap)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("make_heap"),
+	stlOverloads<decltype(Wrapper(std::push_heap)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("push_heap"),
+	stlOverloads<decltype(Wrapper(std::pop_heap)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("pop_heap"),
+	stlOverloads<decltype(Wrapper(std::sort_heap)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("sort_heap"),
 
 	// Minimum/maximum operations
-	{
-		using Func = decltype(Wrapper(std::max_element));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "max_element");
-	}
-	{
-		using Func = decltype(Wrapper(std::min_element));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "min_element");
-	}
-	{
-		using Func = decltype(Wrapper(std::minmax));
-		pushOverloadedFunc(ls,
-			&pass<Func, StackObj, StackObj, StackFunc<bool>>,
-			&pass<Func, StackObj, StackObj>
-		); lua_setfield(ls, -2, "minmax");
-	}
-	{
-		using Func = decltype(Wrapper(std::minmax_element));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "minmax_element");
-	}
-	{
-		using Func = decltype(Wrapper(std::clamp));
-		pushOverloadedFunc(ls,
-			&pass<Func, StackObj, StackObj, StackObj, StackFunc<bool>>,
-			&pass<Func, StackObj, StackObj, StackObj>
-		); lua_setfield(ls, -2, "clamp");
-	}
+	stlOverloads<decltype(Wrapper(std::max_element)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("max_element"),
+	stlOverloads<decltype(Wrapper(std::min_element)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("min_element"),
+	stlOverloads<decltype(Wrapper(std::minmax)),
+		void(StackObj, StackObj, StackFunc<bool>),
+		void(StackObj, StackObj)
+	>("minmax"),
+	stlOverloads<decltype(Wrapper(std::minmax_element)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("minmax_element"),
+	stlOverloads<decltype(Wrapper(std::clamp)),
+		void(StackObj, StackObj, StackObj, StackFunc<bool>),
+		void(StackObj, StackObj, StackObj)
+	>("clamp"),
 
 	// Comparison operations
-	{
-		using Func = decltype(Wrapper(std::equal));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "equal");
-	}
-	{
-		using Func = decltype(Wrapper(std::lexicographical_compare));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "lexicographical_compare");
-	}
+	stlOverloads<decltype(Wrapper(std::equal)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("equal"),
+	stlOverloads<decltype(Wrapper(std::lexicographical_compare)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator)
+	>("lexicographical_compare"),
 
 	// Permutation operations
-	{
-		using Func = decltype(Wrapper(std::is_permutation));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "is_permutation");
-	}
-	{
-		using Func = decltype(Wrapper(std::next_permutation));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "next_permutation");
-	}
-	{
-		using Func = decltype(Wrapper(std::prev_permutation));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackFunc<bool>>,
-			&pass<Func, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "prev_permutation");
-	}
+	stlOverloads<decltype(Wrapper(std::is_permutation)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, ArrayIterator),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("is_permutation"),
+	stlOverloads<decltype(Wrapper(std::next_permutation)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("next_permutation"),
+	stlOverloads<decltype(Wrapper(std::prev_permutation)),
+		void(ArrayIterator, ArrayIterator, StackFunc<bool>),
+		void(ArrayIterator, ArrayIterator)
+	>("prev_permutation"),
 
 
 	// Numeric operations
-	{
-		using Func = decltype(Wrapper(std::iota));
-		pushFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "iota");
-	}
-	{
-		using Func = decltype(Wrapper(std::accumulate));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "accumulate");
-	}
-	{
-		using Func = decltype(Wrapper(std::inner_product));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "inner_product");
-	}
-	{
-		using Func = decltype(Wrapper(std::adjacent_difference));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "adjacent_difference");
-	}
-	{
-		using Func = decltype(Wrapper(std::partial_sum));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "partial_sum");
-	}
-	{
-		using Func = decltype(Wrapper(std::reduce));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj>
-			// &pass<Func, ArrayIterator, ArrayIterator>
-			// ^ not provided, because there is no reasonable default value for a lua variable
-		); lua_setfield(ls, -2, "reduce");
-	}
-	{
-		using Func = decltype(Wrapper(std::exclusive_scan));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "exclusive_scan");
-	}
-	{
-		using Func = decltype(Wrapper(std::inclusive_scan));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>, StackObj>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator>
-		); lua_setfield(ls, -2, "inclusive_scan");
-	}
-	{
-		using Func = decltype(Wrapper(std::transform_reduce));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj>
-		); lua_setfield(ls, -2, "transform_reduce");
-	}
-	{
-		using Func = decltype(Wrapper(std::transform_exclusive_scan));
-		pushFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>>
-		); lua_setfield(ls, -2, "transform_exclusive_scan");
-	}
-	{
-		using Func = decltype(Wrapper(std::transform_inclusive_scan));
-		pushOverloadedFunc(ls,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>, StackFunc<StackObj>, StackObj>,
-			&pass<Func, ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>, StackFunc<StackObj>>
-		); lua_setfield(ls, -2, "transform_inclusive_scan");
-	}
+	func<passPtr<decltype(Wrapper(std::iota)), void(ArrayIterator, ArrayIterator, StackObj)>>("iota"),
+	stlOverloads<decltype(Wrapper(std::accumulate)),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, StackObj)
+	>("accumulate"),
+	stlOverloads<decltype(Wrapper(std::inner_product)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj)
+	>("inner_product"),
+	stlOverloads<decltype(Wrapper(std::adjacent_difference)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("adjacent_difference"),
+	stlOverloads<decltype(Wrapper(std::partial_sum)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("partial_sum"),
+	stlOverloads<decltype(Wrapper(std::reduce)),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, StackObj)
+		// void(ArrayIterator, ArrayIterator)
+		// ^ not provided, because there is no reasonable default value for a lua variable
+	>("reduce"),
+	stlOverloads<decltype(Wrapper(std::exclusive_scan)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj)
+	>("exclusive_scan"),
+	stlOverloads<decltype(Wrapper(std::inclusive_scan)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>, StackObj),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator)
+	>("inclusive_scan"),
+	stlOverloads<decltype(Wrapper(std::transform_reduce)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj)
+	>("transform_reduce"),
+	func<passPtr<decltype(Wrapper(std::transform_exclusive_scan)), void(ArrayIterator, ArrayIterator, ArrayIterator, StackObj, StackFunc<StackObj>, StackFunc<StackObj>)>>("transform_exclusive_scan"),
+	stlOverloads<decltype(Wrapper(std::transform_inclusive_scan)),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>, StackFunc<StackObj>, StackObj),
+		void(ArrayIterator, ArrayIterator, ArrayIterator, StackFunc<StackObj>, StackFunc<StackObj>)
+	>("transform_inclusive_scan")
+};
+
+#undef Wrapper
 
-	#undef Wrapper
+void publishStl(lua_State* ls, PublishMode mode) {
+	publishLibrary(ls, stlLibrary, mode);
 }
 
 }	// end namespace LuaStrap
@@ -3,11 +3,12 @@
 #include "DataTypes.h"
 #include "FuncBinding.h"
 #include "GenericFuncBinding.h"
+#include "Library.h"
 #include "BasicTraits.h"
 #include "LuaRepresObjects.h"
 
 namespace LuaStrap {
-	void publishLuaStrapUtils(lua_State* ls);
-	void publishStl(lua_State* ls);
+	void publishLuaStrapUtils(lua_State* ls, PublishMode mode = PublishMode::eager);	// [-0, +0, m], -1 = target table
+	void publishStl(lua_State* ls, PublishMode mode = PublishMode::eager);			// [-0, +0, m], -1 = target table
 }
 
@@ -0,0 +1,104 @@
+#include "Tests.h"
+#include "../LuaStrap.h"
+#include <vector>
+#include <array>
+#include <iostream>
+
+// Exercises LUASTRAP_DIRECT_ARRAY_ACCESS - both the direct access to the array part of lua tables, and the fallbacks
+// to the public API for the tables which don't fit. To run it, build the tests as a separate target which defines the macro
+// for all of its sources (LuaStrap.cpp included), and has lua's internal headers on its include path. Without the macro,
+// doDirectArrayTest does nothing, so the file can be part of any build.
+#ifdef LUASTRAP_DIRECT_ARRAY_ACCESS
+
+namespace {
+	auto sum(const std::vector<double>& vals) {
+		auto res = 0.0;
+		for (auto v : vals) { res += v; }
+		return res;
+	}
+	auto sumInts(const std::vector<int>& vals) {
+		auto res = 0;
+		for (auto v : vals) { res += v; }
+		return res;
+	}
+	auto centroid(const std::vector<std::array<float, 3>>& points) {
+		auto res = std::array<float, 3>{};
+		for (const auto& p : points) {
+			for (auto i = 0; i < 3; ++i) { res[i] += p[i] / points.size(); }
+		}
+		return res;
+	}
+	auto doubled(std::vector<double> vals) {
+		for (auto& v : vals) { v *= 2; }
+		return vals;
+	}
+	void appendOneTwoThree(std::vector<double>& vals) {
+		vals.insert(vals.end(), { 1, 2, 3 });
+	}
+}
+
+void doDirectArrayTest(lua_State* ls) {
+	namespace lst = LuaStrap;
+
+	lst::pushFunc(ls, sum);
+	lua_setglobal(ls, "sum");
+	lst::pushFunc(ls, sumInts);
+	lua_setglobal(ls, "sumInts");
+	lst::pushFunc(ls, centroid);
+	lua_setglobal(ls, "centroid");
+	lst::pushFunc(ls, doubled);
+	lua_setglobal(ls, "doubled");
+	lst::pushFunc(ls, appendOneTwoThree);
+	lua_setglobal(ls, "appendOneTwoThree");
+
+	auto testFailed = luaL_dostring(ls, R"delim(
+
+	-- Read directly from the array part
+	assert( sum({1, 2.5, 3}) == 6.5 and sum({}) == 0 )
+	assert( sumInts({1, 2, 3}) == 6 and not pcall(sumInts, {1, 2.5}) )
+	local c = centroid({ {0, 0, 0}, {2, 4, 6} })
+	assert( c[1] == 1 and c[2] == 2 and c[3] == 3 )
+	assert( not pcall(centroid, { {0, 0, 0}, {2, 4} }) )
+
+	-- Written directly into the array part
+	local d = doubled({1, 2, 3})
+	assert( #d == 3 and d[1] == 2 and d[3] == 6 )
+	local empty = {}
+	appendOneTwoThree(empty)		-- an empty table gets its array part resized
+	assert( #empty == 3 and empty[3] == 3 )
+
+	-- Holes (elems up to the first nil are read, as through the public API)
+	local holey = {1, 2, 3}
+	holey[2] = nil
+	assert( sum(holey) == 1 )
+
+	-- Elems in the hash part
+	assert( sum({[1] = 1, [2] = 2, [3] = 3}) == 6 )
+	local grown = {5}
+	appendOneTwoThree(grown)		-- the array part is too short, and the table isn't empty
+	assert( #grown == 4 and grown[1] == 5 and grown[4] == 3 )
+
+	-- Metatables (reads are raw, writes respect '__newindex')
+	assert( sum(setmetatable({1, 2}, { __index = function() return 10 end })) == 3 )
+	local newKeys = 0
+	local watched = setmetatable({}, { __newindex = function(t, k, v) newKeys = newKeys + 1; rawset(t, k, v) end })
+	appendOneTwoThree(watched)
+	assert( newKeys == 3 and watched[3] == 3 )
+
+	-- Numeric strings (only readable as floats, through the public API)
+	assert( sum({1, "2", 3}) == 6 )
+	assert( not pcall(sumInts, {1, "2", 3}) )
+
+	)delim");
+
+	if (testFailed) {
+		std::cout << "DirectArrayTest.cpp: " << lua_tostring(ls, -1) << "\n";
+		lua_pop(ls, 1);
+	}
+}
+
+#else
+
+void doDirectArrayTest(lua_State* ls) {}
+
+#endif
@@ -0,0 +1,90 @@
+#include "Tests.h"
+#include "../GenericFuncBinding.h"
+#include "../LuaStrap.h"
+#include "VecMat.h"
+#include <chrono>
+#include <array>
+#include <iostream>
+
+// Compares the default (recursive) dispatch of bulk functions with flat dispatch (see 'flatDispatch'), on the
+// matrix * matrix product of the vector/matrix case study. Both variants are called from the same lua loop over several
+// matrix shapes, and the time per call (loop included) is reported.
+// For comparing the size of the generated code, compile this file on its own with LUASTRAP_BENCH_ONLY_RECURSIVE or
+// LUASTRAP_BENCH_ONLY_FLAT defined (or both, for a baseline binding neither), and compare the object files, e.g.
+//	g++ -std=c++20 -O2 -c -DLUASTRAP_BENCH_ONLY_FLAT FlatDispatchBenchmark.cpp -o flat.o && size flat.o
+
+namespace {
+	using matB = LuaStrap::SimpleAmbiguousBuilder<
+		VecMat::Mat<float, 2, 2>, VecMat::Mat<float, 2, 3>, VecMat::Mat<float, 2, 4>,
+		VecMat::Mat<float, 3, 2>, VecMat::Mat<float, 3, 3>, VecMat::Mat<float, 3, 4>,
+		VecMat::Mat<float, 4, 2>, VecMat::Mat<float, 4, 3>, VecMat::Mat<float, 4, 4>
+	>;
+
+	// Calls the global function 'funcName' 'iterations' times for each shape, and returns the time per call in nanoseconds
+	// (or -1 if the calls failed)
+	auto timeMatMul(lua_State* ls, const char* funcName, int iterations) -> double {
+		lua_getglobal(ls, funcName);
+		lua_setglobal(ls, "benchMatMul");
+		lua_pushinteger(ls, iterations);
+		lua_setglobal(ls, "benchIterations");
+
+		auto start = std::chrono::steady_clock::now();
+		auto failed = luaL_dostring(ls, R"delim(
+
+		local shapes = {
+			{ {1, 2, 3, 4}, {5, 6, 7, 8} },										-- 2x2 * 2x2
+			{ {1, 2, 3, 4, 5, 6}, {1, 2, 3, 4, 5, 6} },							-- 6 elems * 6 elems
+			{ {1, 2, 3, 4, 5, 6, 7, 8, 9}, {9, 8, 7, 6, 5, 4, 3, 2, 1} },		-- 3x3 * 3x3
+			{ {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}, {1, 0, 0, 0, 1, 0, 0, 0, 1} },		-- 12 elems * 3x3
+			{ {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}, {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1} },	-- 4x4 * 4x4
+		}
+		for _, shape in ipairs(shapes) do
+			local a, b = shape[1], shape[2]
+			for i = 1, benchIterations do
+				benchMatMul(a, b)
+			end
+		end
+
+		)delim");
+		auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		if (failed) {
+			std::cout << "FlatDispatchBenchmark.cpp: " << lua_tostring(ls, -1) << "\n";
+			lua_pop(ls, 1);
+			return -1;
+		}
+		return elapsed / (5.0 * iterations);
+	}
+}
+
+void doFlatDispatchBenchmark(lua_State* ls) {
+	namespace lst = LuaStrap;
+	constexpr auto iterations = 20000;
+
+	struct Variant {
+		const char* funcName;
+		const char* description;
+	};
+	auto variants = std::array<Variant, 2>{};
+	auto variantCount = 0;
+
+#ifndef LUASTRAP_BENCH_ONLY_FLAT
+	lst::pushBulkFunc<matB, matB>(ls, lstrapFuncWrapper(VecMat::operator*));
+	lua_setglobal(ls, "matMatMulRecursive");
+	variants[variantCount++] = { "matMatMulRecursive", "recursive dispatch" };
+#endif
+#ifndef LUASTRAP_BENCH_ONLY_RECURSIVE
+	lst::pushBulkFunc<matB, matB>(ls, lst::flatDispatch(lstrapFuncWrapper(VecMat::operator*)));
+	lua_setglobal(ls, "matMatMulFlat");
+	variants[variantCount++] = { "matMatMulFlat", "flat dispatch" };
+#endif
+
+	for (auto i = 0; i < variantCount; ++i) {
+		timeMatMul(ls, variants[i].funcName, iterations / 10);	// warm-up
+		auto nsPerCall = timeMatMul(ls, variants[i].funcName, iterations);
+		if (nsPerCall >= 0) {
+			std::cout << "FlatDispatchBenchmark.cpp: matrix * matrix, " << variants[i].description << ", "
+				<< nsPerCall << " ns/call\n";
+		}
+	}
+}
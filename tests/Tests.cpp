@@ -3,6 +3,8 @@
 #include <map>
 #include <variant>
 #include <string>
+#include <string_view>
+#include <span>
 #include <vector>
 #include <array>
 #include <iostream>
@@ -20,11 +22,35 @@ void eraseKey(
 ) {
 	data.erase(key);
 }
+auto firstWord(std::string_view text) {
+	return text.substr(0, text.find(' '));
+}
+auto byteCount(std::span<const std::byte> bytes) {
+	return int(bytes.size());
+}
+auto joinWords(const std::vector<std::string_view>& words) {
+	auto res = std::string{};
+	for (auto word : words) {
+		res += word;
+	}
+	return res;
+}
+auto entryKind(std::variant<std::vector<double>, std::map<std::string, double>> entries) {
+	return int(entries.index());
+}
+
+static_assert(LuaStrap::luaStackNeed<std::vector<std::map<std::string, double>>>() == 4);	// vector, map, key, value
+static_assert(!LuaStrap::Bakeable<std::vector<std::string_view>>);
+static_assert(!LuaStrap::PrimitiveSignature<void, std::string&&> && LuaStrap::PrimitiveSignature<void, const std::string&>);
 
 // Item 2 - Overloaded/generic functions
 auto plus(double lhs, double rhs) { return lhs + rhs; }
 auto plus(std::string lhs, std::string rhs) { return lhs + rhs; }
 auto plus(auto lhs, auto rhs) { return lhs + rhs; }		// generic function taking anything
+void append(std::vector<double>& dest, std::vector<int> src) { dest.insert(dest.end(), src.begin(), src.end()); }
+void append(std::vector<double>& dest, std::vector<double> src) { dest.insert(dest.end(), src.begin(), src.end()); }
+auto describe(std::vector<int>) { return std::string{ "ints" }; }
+auto describe(std::vector<double>) { return std::string{ "doubles" }; }
 
 // Item 3 - Aggregates
 struct Person {
@@ -47,6 +73,16 @@ struct LuaStrap::Traits<Person> : LuaStrap::AggregateTraits<Person> {
 		std::pair{ "isHomeless", &Person::isHomeless }
 	};
 };
+static_assert(LuaStrap::luaStackNeed<Person>() == 4);	// table, member names, member name, member value
+
+// The aggregate helpers can also be given other member maps than the one in the traits (even of the same type)
+inline auto germanPersonMembers = std::tuple{
+	std::pair{ "name", &Person::name },
+	std::pair{ "adresse", &Person::address },
+	std::pair{ "alter", &Person::age },
+	std::pair{ "isAdult", &Person::isAdult },
+	std::pair{ "isHomeless", &Person::isHomeless }
+};
 
 /* Macro syntax:
 lstrapAggrTraits(Person)
@@ -106,12 +142,27 @@ void doLuaTests(lua_State* ls) {
 	lua_createtable(ls, 0, 0);
 	lst::publishStl(ls);
 	lua_setglobal(ls, "stl");
+	lua_createtable(ls, 0, 0);
+	lst::publishStl(ls, lst::PublishMode::lazy);
+	lua_setglobal(ls, "lazyStl");
 
 	// Item 1
 	lst::pushFunc(ls, average);
 	lua_setglobal(ls, "average");
 	lst::pushFunc(ls, eraseKey);
 	lua_setglobal(ls, "eraseKey");
+	lst::pushFunc(ls, entryKind);
+	lua_setglobal(ls, "entryKind");
+	lst::pushFunc(ls, firstWord);
+	lua_setglobal(ls, "firstWord");
+	lst::pushFunc(ls, byteCount);
+	lua_setglobal(ls, "byteCount");
+	lst::pushFunc(ls, joinWords);
+	lua_setglobal(ls, "joinWords");
+	lst::pushFunc<&average>(ls);
+	lua_setglobal(ls, "averageStatic");
+	lst::pushTrustedFunc<&average>(ls);
+	lua_setglobal(ls, "averageTrusted");
 
 	// Item 2
 	lst::pushOverloadedFunc(ls,
@@ -123,6 +174,30 @@ void doLuaTests(lua_State* ls) {
 		// ...
 	);
 	lua_setglobal(ls, "plus");
+	lst::pushOverloadedFunc<
+		(double(*)(double, double)) & plus,
+		(std::string(*)(std::string, std::string)) & plus
+	>(ls);
+	lua_setglobal(ls, "plusStatic");
+	lst::pushOverloadedFunc(ls,
+		(void(*)(std::vector<double>&, std::vector<int>)) & append,
+		(void(*)(std::vector<double>&, std::vector<double>)) & append
+	);
+	lua_setglobal(ls, "append");
+	lst::pushOverloadedFunc(ls,
+		(std::string(*)(std::vector<int>)) & describe,
+		(std::string(*)(std::vector<double>)) & describe
+	);
+	lua_setglobal(ls, "describe");
+	static constexpr auto mathLib = lst::Library{
+		lst::func<&average>("average"),
+		lst::overloadedFunc<
+			(double(*)(double, double)) & plus,
+			(std::string(*)(std::string, std::string)) & plus
+		>("plus")
+	};
+	lst::pushLibrary(ls, mathLib);
+	lua_setglobal(ls, "mathLib");
 
 	// Item 3
 	lst::pushFunc(ls, +[] { return Person{}; });
@@ -130,6 +205,20 @@ void doLuaTests(lua_State* ls) {
 	// ^ providing a factory function is NOT neccessary, but useful, see the lua code
 	lst::pushFunc(ls, mature);
 	lua_setglobal(ls, "mature");
+	lua_CFunction fromGerman = [](lua_State* ls) {
+		auto person = lst::aggregateRead<Person>(ls, 1, germanPersonMembers);
+		person ? lst::write(ls, *person) : lua_pushnil(ls);
+		return 1;
+	};
+	lua_pushcfunction(ls, fromGerman);
+	lua_setglobal(ls, "fromGerman");
+	lua_CFunction toGerman = [](lua_State* ls) {
+		auto person = lst::read<Person>(ls, 1);
+		person ? lst::aggregateWrite(ls, *person, germanPersonMembers) : lua_pushnil(ls);
+		return 1;
+	};
+	lua_pushcfunction(ls, toGerman);
+	lua_setglobal(ls, "toGerman");
 
 	// Item 4
 	lst::pushFunc(ls, process);
@@ -143,8 +232,15 @@ void doLuaTests(lua_State* ls) {
 
 	auto testFailed = luaL_dostring(ls, R"delim(
 
+	-- Initialization
+	assert( rawget(stl, "sort") ~= nil )
+	assert( rawget(lazyStl, "sort") == nil and lazyStl.sort ~= nil and rawget(lazyStl, "sort") == lazyStl.sort )
+	assert( lazyStl.notAnAlgorithm == nil )
+
 	-- Item 1
 	assert( average(3, 5) == 4 )
+	assert( average("3", 5) == 4 )
+	assert( not pcall(average, {}, 5) )		-- rejected by lua type, without attempting to read it
 	local tbl = {
 		["abcd"] = {1.1, 2.2, 3.3},
 		["efg"] = {},
@@ -153,13 +249,35 @@ void doLuaTests(lua_State* ls) {
 	eraseKey(tbl, "abcd")
 	eraseKey(tbl, 50)
 	assert( tbl["abcd"] == nil and tbl[50] == nil )
+	assert( not pcall(eraseKey, 5, 50) )
+	assert( averageStatic(3, 5) == 4 )
+	assert( averageTrusted(3, 5) == 4 )
+	assert( not pcall(averageTrusted, 3) )	-- too few args still raise the usual error
+	assert( firstWord("hello world") == "hello" )	-- these borrow the lua strings
+	assert( byteCount("a\0b") == 3 )
+	local words = markedForBaking({"a", "b"})
+	assert( joinWords(words) == "ab" )
+	collectgarbage()
+	assert( joinWords(words) == "ab" )	-- borrowing args aren't baked, so the strings stay alive
+	assert( entryKind({1, 2}) == 0 and entryKind({}) == 0 )
+	assert( entryKind({a = 1}) == 1 )	-- a keyed table isn't read as an empty array
 
 	-- Item 2
 	assert( plus(10, 5) == 15 )
 	assert( plus("Hello, ", "world!") == "Hello, world!" )
+	assert( plus("a\0", "b") == "a\0b" )		-- strings may contain zeros
 	local sum1 = plus({1, 2}, {2, 3})		assert( sum1[1] == 3 and sum1[2] == 5 )
 	local sum2 = plus({1, 2}, 2)			assert( sum2[1] == 3 and sum2[2] == 2 )
 	local sum3 = plus(2, {1, 2})			assert( sum3[1] == 3 and sum3[2] == 2 )
+	assert( plus("a", "b") == "ab" and plus("1", "2") == 3 and plus("a", "b") == "ab" and plus({1, 2}, 2)[1] == 3 and plus("1", "2") == 3 )
+	assert( describe({1.5}) == "doubles" and describe({1, 2}) == "ints" and describe({2.5}) == "doubles" and describe({3}) == "ints" )	-- not decided by earlier calls
+	assert( plusStatic(10, 5) == 15 and plusStatic("a", "b") == "ab" )
+	local appended = {1}
+	append(appended, {2.5, 3})		-- the 1st arg, read for the 1st overload, is reused for the 2nd one
+	append(appended, {4})
+	assert( #appended == 4 and appended[2] == 2.5 and appended[4] == 4 )
+	assert( not pcall(plusStatic, {1, 2}, 2) )
+	assert( mathLib.average(3, 5) == 4 and mathLib.plus("a", "b") == "ab" )
 
 	-- Item 3
 	local p = makePerson()
@@ -171,6 +289,14 @@ void doLuaTests(lua_State* ls) {
 	local p2 = { name = "Anna", age = 15, address = "" }	-- If desired, aggregates can be created directly, without using a factory function.
 	mature(p2)												-- Free functions can be called over these...
 	--p2:isAdult()	-- Error!!								-- ...but member functions can not.
+	local p3 = { age = 20, address = "Baker St", name = "Carl", nickname = "C" }
+	mature(p3)
+	assert( p3.age == 20 and p3.name == "Carl" and p3.nickname == "C" and not pcall(mature, { name = "Dana", age = 5 }) )
+	local p4 = fromGerman({ name = "Eve", adresse = "", alter = 30 })
+	mature(p4)
+	assert( p4.age == 30 and p4.alter == nil and fromGerman(p4) == nil )
+	local p5 = toGerman(p4)
+	assert( p5.alter == 30 and p5.age == nil and toGerman(p5) == nil )
 
 	-- Item 4
 	local pointCloud = { {0,1,0}, {2.5, 1, 0.5}, --[[ ... very much data ]] }
@@ -201,6 +327,7 @@ void doLuaTests(lua_State* ls) {
 	sc:render(640, 480)
 	sc:clearAllObjects()
 	assert( sc:getObjCount() == 0 )
+	assert( not pcall(mature, sc) )		-- baked data of a different type is rejected
 
 	)delim");
 
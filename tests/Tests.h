@@ -4,3 +4,6 @@ struct lua_State;
 void doLuaTests(lua_State* ls);
 void doVectorMatrixTest(lua_State* ls);
 void doStlTest(lua_State* ls);
+void doThreadingTest();
+void doFlatDispatchBenchmark(lua_State* ls);	// reports the time per call of recursive vs. flat dispatch
+void doDirectArrayTest(lua_State* ls);	// does nothing unless LUASTRAP_DIRECT_ARRAY_ACCESS is defined (see DirectArrayTest.cpp)
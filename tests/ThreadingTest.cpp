@@ -0,0 +1,116 @@
+#include "Tests.h"
+#include "../LuaStrap.h"
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+
+// Runs independent lua_States on worker threads, all using LuaStrap at once (no locking on the user's side).
+// The amount of threads is scaled up to the core count, and the throughput is reported for each step.
+
+namespace {
+	struct Accumulator {
+		double sum = 0;
+		int count = 0;
+
+		void add(double val) { sum += val; ++count; }
+		auto mean() const { return count == 0 ? 0.0 : sum / count; }
+	};
+
+	auto sumAll(const std::vector<double>& vals) {
+		auto res = 0.0;
+		for (auto v : vals) { res += v; }
+		return res;
+	}
+	void appendTo(std::vector<int>& vals, int val) { vals.push_back(val); }
+}
+
+template <>
+struct LuaStrap::Traits<Accumulator> {
+	inline static auto members = std::tuple{
+		std::pair{ "add", &Accumulator::add },
+		std::pair{ "mean", &Accumulator::mean }
+	};
+};
+
+static auto runState(int iterations) -> bool {
+	namespace lst = LuaStrap;
+	auto* ls = luaL_newstate();
+	luaL_openlibs(ls);
+
+	lua_geti(ls, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	lst::publishLuaStrapUtils(ls, lst::PublishMode::lazy);
+	lua_pop(ls, 1);
+
+	lua_createtable(ls, 0, 0);
+	lst::publishStl(ls, lst::PublishMode::lazy);
+	lua_setglobal(ls, "stl");
+
+	lst::pushFunc(ls, lst::makeBakedData<Accumulator>);
+	lua_setglobal(ls, "makeAccumulator");
+	lst::pushFunc(ls, sumAll);
+	lua_setglobal(ls, "sumAll");
+	lst::pushFunc(ls, appendTo);
+	lua_setglobal(ls, "appendTo");
+
+	lua_pushinteger(ls, iterations);
+	lua_setglobal(ls, "iterations");
+
+	auto testFailed = luaL_dostring(ls, R"delim(
+
+	for i = 1, iterations do
+		local acc = makeAccumulator()
+		acc:add(i)
+		acc:add(i + 2)
+		assert( acc:mean() == i + 1 )
+
+		local vals = markedForBaking({ 1.5, 2.5, i })
+		assert( sumAll(vals) == 4 + i )
+		assert( sumAll(vals) == 4 + i )
+
+		local ints = { 3, 1 }
+		appendTo(ints, 2)
+		stl.sort({ints, 1}, {ints, #ints + 1})
+		assert( ints[1] == 1 and ints[2] == 2 and ints[3] == 3 )
+	end
+
+	)delim");
+
+	if (testFailed) {
+		static auto outputMutex = std::mutex{};
+		auto lock = std::scoped_lock{ outputMutex };
+		std::cout << "ThreadingTest.cpp: " << lua_tostring(ls, -1) << "\n";
+	}
+	lua_close(ls);
+	return !testFailed;
+}
+
+void doThreadingTest() {
+	constexpr auto iterations = 2000;
+	auto maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	for (auto threadCount = 1u; ; threadCount = std::min(threadCount * 2, maxThreads)) {
+		auto start = std::chrono::steady_clock::now();
+
+		auto results = std::vector<char>(threadCount, false);
+		auto threads = std::vector<std::thread>{};
+		for (auto i = 0u; i < threadCount; ++i) {
+			threads.emplace_back([&results, i] { results[i] = runState(iterations); });
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		auto failed = std::count(results.begin(), results.end(), false);
+		std::cout << "ThreadingTest.cpp: " << threadCount << " lua_States, "
+			<< (threadCount * iterations) / elapsed << " iterations/s"
+			<< (failed ? ", FAILED" : "") << "\n";
+
+		if (threadCount == maxThreads) {
+			break;
+		}
+	}
+}
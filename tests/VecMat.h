@@ -0,0 +1,244 @@
+#pragma once
+#include "../LuaStrap.h"
+#include "../BasicTraits.h"
+#include <cmath>
+#include <array>
+
+namespace VecMat {
+
+	// An example collection of generic functions over arbitrary vectors/matrices.  
+	// VectorMatrixTest.cpp binds this collection to lua and tries to use it, and FlatDispatchBenchmark.cpp times a part of it.
+
+	template <typename T>
+	struct VectorTraits {}; // specialize this for custom vector classes
+	template <typename T>
+	concept Vector =
+		requires(T & t, const T & ct, const typename VectorTraits<T>::Elem & elm) {
+			{ VectorTraits<T>::dimension } -> std::convertible_to<int>;
+			{ VectorTraits<T>::getElem(ct, int{}) } -> std::convertible_to<typename VectorTraits<T>::Elem>;
+			{ VectorTraits<T>::setElem(t, int{}, elm) };
+	}&&
+		VectorTraits<std::decay_t<T>>::dimension > 0;
+
+	template <typename T, int howManyElems> struct Vec { std::array<T, howManyElems> elems; };
+	template <typename T, int howManyElems> struct VectorTraits<Vec<T, howManyElems>> {
+		using Elem = T;
+		constexpr static int dimension = howManyElems;
+		constexpr static auto getElem(const Vec<T, howManyElems>& vec, int idx) -> const T& { return vec.elems[idx]; }
+		constexpr static void setElem(Vec<T, howManyElems>& vec, int idx, const T& val) { vec.elems[idx] = val; }
+	};
+	template <Vector V>
+	struct LuaStrap::Traits<V> {
+		// ElemT must not push on read
+		// { [1] = elm1, ... }
+		using VecTraits = VecMat::VectorTraits<V>;
+		using ElemT = std::remove_cvref_t < std::invoke_result_t<decltype([](const V& v, int i) { return VecTraits::getElem(v, i); }), V, int >> ;
+		static constexpr LuaStrap::LuaArrayShape luaArrayShape = { VecTraits::dimension, VecTraits::dimension, LuaStrap::acceptedLuaTypes<ElemT>() };
+		static constexpr int luaStackNeed = LuaStrap::luaStackNeedAbove(1, LuaStrap::luaStackNeed<ElemT>());
+		static auto read(lua_State* ls, int idx) -> std::optional<V> {
+			auto res = std::optional<V>{ std::in_place };
+			auto howManyRead = LuaStrap::readArrayUpTo<ElemT>(ls, idx, VecTraits::dimension, [&res, elmI = 0](const ElemT& elem) mutable {
+				VecTraits::setElem(*res, elmI++, elem);
+				});
+			if (howManyRead == VecTraits::dimension) {
+				return res;
+			}
+			else {
+				return std::nullopt;
+			}
+		}
+		static void emplace(lua_State* ls, const V& v, int absIdx) {
+			for (auto i = 0; i < VecTraits::dimension; ++i) {
+				LuaStrap::writeReserved<ElemT>(ls, VecTraits::getElem(v, i));
+				lua_seti(ls, absIdx, i + 1);
+			}
+		}
+		static auto tableSize(const V&) -> LuaStrap::LuaTableSize { return { VecTraits::dimension, 0 }; }
+	};
+
+	template <typename T>
+	struct MatrixTraits {};	// specialize this for custom matrix classes
+	template <typename T>
+	concept Matrix =
+		requires(T & t, const T & ct, const typename MatrixTraits<T>::Elem & elm) {
+			{ MatrixTraits<T>::dimensionX } -> std::convertible_to<int>;
+			{ MatrixTraits<T>::dimensionY } -> std::convertible_to<int>;
+			{ MatrixTraits<T>::getElem(ct, int{}, int{}) } -> std::convertible_to<typename MatrixTraits<T>::Elem>;
+			{ MatrixTraits<T>::setElem(t, int{}, int{}, elm) };
+			// +x goes right, +y goes down!
+	}&&
+		MatrixTraits<T>::dimensionX > 0 &&
+		MatrixTraits<T>::dimensionY > 0;
+
+	template <typename T, int w, int h> struct Mat { std::array<T, w* h> elems; };
+	template <typename T, int w, int h> struct MatrixTraits<Mat<T, w, h>> {
+		using Elem = T;
+		constexpr static int dimensionX = w;
+		constexpr static int dimensionY = h;
+
+		constexpr static auto getElem(const Mat<T, w, h>& mat, int i) -> const T& { return mat.elems[i]; }
+		constexpr static auto getElem(const Mat<T, w, h>& mat, int x, int y) -> const T& { return mat.elems[x + y*w]; }
+		constexpr static void setElem(Mat<T, w, h>& mat, int i, const T& val) { mat.elems[i] = val; }
+		constexpr static void setElem(Mat<T, w, h>& mat, int x, int y, const T& val) { mat.elems[x + y*w] = val; }
+	};
+	template <Matrix M>
+	struct LuaStrap::Traits<M> {
+		// ElemT must not push on read
+		// { [1] = elm1, ... }
+		using MatTraits = VecMat::MatrixTraits<M>;
+		using ElemT = MatTraits::Elem;
+		constexpr static auto matSize = MatTraits::dimensionX * MatTraits::dimensionY;
+		static constexpr LuaStrap::LuaArrayShape luaArrayShape = { matSize, matSize, LuaStrap::acceptedLuaTypes<ElemT>() };
+		static constexpr int luaStackNeed = LuaStrap::luaStackNeedAbove(1, LuaStrap::luaStackNeed<ElemT>());
+
+		static auto read(lua_State* ls, int idx) -> std::optional<M> {
+			if (lua_type(ls, idx) != LUA_TTABLE) {
+				return std::nullopt;
+			}
+
+			M res;
+			auto readCount = LuaStrap::readArrayUpTo<ElemT>(ls, idx, matSize, [&res, i = 0](const ElemT& val) mutable {
+				MatTraits::setElem(res, i, val);
+				++i;
+				});
+
+			if (readCount == matSize) {
+				return std::optional{ res };
+			}
+			else {
+				return std::nullopt;
+			}
+		}
+		static void emplace(lua_State* ls, const M& v, int idx) {
+			for (auto i = 0; i < matSize; ++i) {
+				LuaStrap::writeReserved(ls, MatTraits::getElem(v, i));
+				lua_seti(ls, idx, i + 1);
+			}
+		}
+		static auto tableSize(const M&) -> LuaStrap::LuaTableSize { return { matSize, 0 }; }
+	};
+
+	template <Vector V>
+	constexpr auto lengthSqr(const V& v) {
+		auto sum = VectorTraits<V>::getElem(v, 0) * VectorTraits<V>::getElem(v, 0);
+		for (auto i = 1; i < VectorTraits<V>::dimension; ++i) {
+			sum += VectorTraits<V>::getElem(v, i) * VectorTraits<V>::getElem(v, i);
+		}
+		return sum;
+	}
+
+	template <Vector V>
+	constexpr auto length(const V& v) {
+		return std::sqrt(lengthSqr(v));
+	}
+
+	template <Vector VecA, Vector VecB>
+	constexpr auto scaleAlong(VecA& a, const VecB& axis, typename VectorTraits<VecA>::Elem sc)
+		requires (VectorTraits<VecA>::dimension == VectorTraits<VecB>::dimension)
+	{
+		auto d = dot(a, axis);
+		for (auto index = 0; index < VectorTraits<VecA>::dimension; ++index) {
+			VectorTraits<VecA>::setElem(a, index, VectorTraits<VecA>::getElem(a, index) + VectorTraits<VecB>::getElem(axis, index) * d * (sc - 1));
+		}
+	}
+
+	template <Vector VecA, Vector VecB>
+	constexpr auto dot(const VecA& a, const VecB& b)
+		requires (VectorTraits<VecA>::dimension == VectorTraits<VecB>::dimension)
+	{
+		auto result = decltype(VectorTraits<VecA>::getElem(a, 0) * VectorTraits<VecB>::getElem(b, 0)){0};
+		for (auto index = 0; index < VectorTraits<VecA>::dimension; ++index) {
+			result += VectorTraits<VecA>::getElem(a, index) * VectorTraits<VecB>::getElem(b, index);
+		}
+		return result;
+	}
+
+	template <Vector V>
+	constexpr auto cross(const V& lhs, const V& rhs)
+		requires (VectorTraits<V>::dimension == 3)
+	{
+		using Traits = VectorTraits<V>;
+		V res;
+		Traits::setElem(res, 0, Traits::getElem(lhs, 1) * Traits::getElem(rhs, 2) - Traits::getElem(lhs, 2) * Traits::getElem(rhs, 1));
+		Traits::setElem(res, 1, Traits::getElem(lhs, 2) * Traits::getElem(rhs, 0) - Traits::getElem(lhs, 0) * Traits::getElem(rhs, 2));
+		Traits::setElem(res, 2, Traits::getElem(lhs, 0) * Traits::getElem(rhs, 1) - Traits::getElem(lhs, 1) * Traits::getElem(rhs, 0));
+		return res;
+	}
+
+	template <Vector V>
+	constexpr auto normalize(V& v) {
+		auto len = length(v);
+		for (auto index = 0; index < VectorTraits<V>::dimension; ++index) {
+			VectorTraits<V>::setElem(v, index, VectorTraits<V>::getElem(v, index) / len);
+		}
+	}
+
+	template <Vector VecA, Vector VecB>
+	constexpr auto& operator+=(VecA& a, const VecB& b)
+		requires (VectorTraits<VecA>::dimension == VectorTraits<VecB>::dimension)
+	{
+		for (auto index = 0; index < VectorTraits<VecA>::dimension; ++index) {
+			VectorTraits<VecA>::setElem(a, index, VectorTraits<VecA>::getElem(a, index) + VectorTraits<VecB>::getElem(b, index));
+		}
+		return a;
+	}
+
+	template <Matrix MatA, Matrix MatB>
+		requires (MatrixTraits<MatA>::dimensionX == MatrixTraits<MatB>::dimensionY)
+	constexpr auto operator*(const MatA& a, const MatB& b) {
+		using ATr = MatrixTraits<MatA>;
+		using BTr = MatrixTraits<MatB>;
+		using MultiplyResult = decltype(ATr::getElem(a, 0, 0) * BTr::getElem(b, 0, 0));
+		using AdditionResult = decltype(std::declval<MultiplyResult>() + std::declval<MultiplyResult>());
+		constexpr auto bWidth = BTr::dimensionX;
+		constexpr auto aHeight = ATr::dimensionY;
+		constexpr auto depth = ATr::dimensionX;
+
+		auto result = Mat<AdditionResult, bWidth, aHeight>{};
+		using RTr = MatrixTraits<decltype(result)>;
+
+		for (int index = 0; index < bWidth * aHeight; ++index) {
+			int cellX = index % bWidth;
+			int cellY = index / bWidth;
+			auto sum = AdditionResult(0);
+			for (int i = 0; i < depth; ++i) {
+				sum += ATr::getElem(a, i, cellY) * BTr::getElem(b, cellX, i);
+			}
+			RTr::setElem(result, cellX, cellY, sum);
+		}
+		return result;
+	}
+
+	template <Matrix M>
+		requires (MatrixTraits<M>::dimensionX == 1)
+	auto toVector(const M& mat) {
+		using MTr = MatrixTraits<M>;
+		using Res = Vec<typename MTr::Elem, MTr::dimensionY>;
+		using RTr = VectorTraits<Res>;
+
+		Res res;
+		for (auto i = 0; i < MTr::dimensionY; ++i) {
+			RTr::setElem(res, i, MTr::getElem(mat, 0, i));
+		}
+		return res;
+	}
+
+	template <Vector V>
+	auto toMatrixColumn(const V& vec) {
+		using VTr = VectorTraits<V>;
+		using Res = Mat<typename VTr::Elem, 1, VTr::dimension>;
+		using RTr = MatrixTraits<Res>;
+
+		Res res;
+		for (auto i = 0; i < VTr::dimension; ++i) {
+			RTr::setElem(res, 0, i, VTr::getElem(vec, i));
+		}
+		return res;
+	}
+
+	template <Matrix M, Vector V>
+		requires (MatrixTraits<M>::dimensionX == VectorTraits<V>::dimension)
+	constexpr auto operator*(const M& a, const V& b) {
+		return toVector(a * toMatrixColumn(b));
+	}
+}
@@ -1,243 +1,10 @@
 #include "Tests.h"
 #include "../GenericFuncBinding.h"
-#include "../BasicTraits.h"
-#include <cmath>
-#include <array>
+#include "../Library.h"
+#include "../LuaStrap.h"
+#include "VecMat.h"
 #include <iostream>
 
-namespace VecMat {
-
-	// An example collection of generic functions over arbitrary vectors/matrices.  
-	// The test will bind this collection to lua and try to use it.
-
-	template <typename T>
-	struct VectorTraits {}; // specialize this for custom vector classes
-	template <typename T>
-	concept Vector =
-		requires(T & t, const T & ct, const typename VectorTraits<T>::Elem & elm) {
-			{ VectorTraits<T>::dimension } -> std::convertible_to<int>;
-			{ VectorTraits<T>::getElem(ct, int{}) } -> std::convertible_to<typename VectorTraits<T>::Elem>;
-			{ VectorTraits<T>::setElem(t, int{}, elm) };
-	}&&
-		VectorTraits<std::decay_t<T>>::dimension > 0;
-
-	template <typename T, int howManyElems> struct Vec { std::array<T, howManyElems> elems; };
-	template <typename T, int howManyElems> struct VectorTraits<Vec<T, howManyElems>> {
-		using Elem = T;
-		constexpr static int dimension = howManyElems;
-		constexpr static auto getElem(const Vec<T, howManyElems>& vec, int idx) -> const T& { return vec.elems[idx]; }
-		constexpr static void setElem(Vec<T, howManyElems>& vec, int idx, const T& val) { vec.elems[idx] = val; }
-	};
-	template <Vector V>
-	struct LuaStrap::Traits<V> {
-		// ElemT must not push on read
-		// { [1] = elm1, ... }
-		using VecTraits = VecMat::VectorTraits<V>;
-		using ElemT = std::remove_cvref_t < std::invoke_result_t<decltype([](const V& v, int i) { return VecTraits::getElem(v, i); }), V, int >> ;
-		static auto read(lua_State* ls, int idx) -> std::optional<V> {
-			auto res = std::optional<V>{ std::in_place };
-			auto howManyRead = LuaStrap::readArrayUpTo<ElemT>(ls, idx, VecTraits::dimension, [&res, elmI = 0](const ElemT& elem) mutable {
-				VecTraits::setElem(*res, elmI++, elem);
-				});
-			if (howManyRead == VecTraits::dimension) {
-				return res;
-			}
-			else {
-				return std::nullopt;
-			}
-		}
-		static void emplace(lua_State* ls, const V& v, int absIdx) {
-			for (auto i = 0; i < VecTraits::dimension; ++i) {
-				LuaStrap::write<ElemT>(ls, VecTraits::getElem(v, i));
-				lua_seti(ls, absIdx, i + 1);
-			}
-		}
-	};
-
-	template <typename T>
-	struct MatrixTraits {};	// specialize this for custom matrix classes
-	template <typename T>
-	concept Matrix =
-		requires(T & t, const T & ct, const typename MatrixTraits<T>::Elem & elm) {
-			{ MatrixTraits<T>::dimensionX } -> std::convertible_to<int>;
-			{ MatrixTraits<T>::dimensionY } -> std::convertible_to<int>;
-			{ MatrixTraits<T>::getElem(ct, int{}, int{}) } -> std::convertible_to<typename MatrixTraits<T>::Elem>;
-			{ MatrixTraits<T>::setElem(t, int{}, int{}, elm) };
-			// +x goes right, +y goes down!
-	}&&
-		MatrixTraits<T>::dimensionX > 0 &&
-		MatrixTraits<T>::dimensionY > 0;
-
-	template <typename T, int w, int h> struct Mat { std::array<T, w* h> elems; };
-	template <typename T, int w, int h> struct MatrixTraits<Mat<T, w, h>> {
-		using Elem = T;
-		constexpr static int dimensionX = w;
-		constexpr static int dimensionY = h;
-
-		constexpr static auto getElem(const Mat<T, w, h>& mat, int i) -> const T& { return mat.elems[i]; }
-		constexpr static auto getElem(const Mat<T, w, h>& mat, int x, int y) -> const T& { return mat.elems[x + y*w]; }
-		constexpr static void setElem(Mat<T, w, h>& mat, int i, const T& val) { mat.elems[i] = val; }
-		constexpr static void setElem(Mat<T, w, h>& mat, int x, int y, const T& val) { mat.elems[x + y*w] = val; }
-	};
-	template <Matrix M>
-	struct LuaStrap::Traits<M> {
-		// ElemT must not push on read
-		// { [1] = elm1, ... }
-		using MatTraits = VecMat::MatrixTraits<M>;
-		using ElemT = MatTraits::Elem;
-		constexpr static auto matSize = MatTraits::dimensionX * MatTraits::dimensionY;
-
-		static auto read(lua_State* ls, int idx) -> std::optional<M> {
-			if (lua_type(ls, idx) != LUA_TTABLE) {
-				return std::nullopt;
-			}
-
-			M res;
-			auto readCount = LuaStrap::readArrayUpTo<ElemT>(ls, idx, matSize, [&res, i = 0](const ElemT& val) mutable {
-				MatTraits::setElem(res, i, val);
-				++i;
-				});
-
-			if (readCount == matSize) {
-				return std::optional{ res };
-			}
-			else {
-				return std::nullopt;
-			}
-		}
-		static void emplace(lua_State* ls, const M& v, int idx) {
-			for (auto i = 0; i < matSize; ++i) {
-				LuaStrap::write(ls, MatTraits::getElem(v, i));
-				lua_seti(ls, idx, i + 1);
-			}
-		}
-	};
-
-	template <Vector V>
-	constexpr auto lengthSqr(const V& v) {
-		auto sum = VectorTraits<V>::getElem(v, 0) * VectorTraits<V>::getElem(v, 0);
-		for (auto i = 1; i < VectorTraits<V>::dimension; ++i) {
-			sum += VectorTraits<V>::getElem(v, i) * VectorTraits<V>::getElem(v, i);
-		}
-		return sum;
-	}
-
-	template <Vector V>
-	constexpr auto length(const V& v) {
-		return std::sqrt(lengthSqr(v));
-	}
-
-	template <Vector VecA, Vector VecB>
-	constexpr auto scaleAlong(VecA& a, const VecB& axis, typename VectorTraits<VecA>::Elem sc)
-		requires (VectorTraits<VecA>::dimension == VectorTraits<VecB>::dimension)
-	{
-		auto d = dot(a, axis);
-		for (auto index = 0; index < VectorTraits<VecA>::dimension; ++index) {
-			VectorTraits<VecA>::setElem(a, index, VectorTraits<VecA>::getElem(a, index) + VectorTraits<VecB>::getElem(axis, index) * d * (sc - 1));
-		}
-	}
-
-	template <Vector VecA, Vector VecB>
-	constexpr auto dot(const VecA& a, const VecB& b)
-		requires (VectorTraits<VecA>::dimension == VectorTraits<VecB>::dimension)
-	{
-		auto result = decltype(VectorTraits<VecA>::getElem(a, 0) * VectorTraits<VecB>::getElem(b, 0)){0};
-		for (auto index = 0; index < VectorTraits<VecA>::dimension; ++index) {
-			result += VectorTraits<VecA>::getElem(a, index) * VectorTraits<VecB>::getElem(b, index);
-		}
-		return result;
-	}
-
-	template <Vector V>
-	constexpr auto cross(const V& lhs, const V& rhs)
-		requires (VectorTraits<V>::dimension == 3)
-	{
-		using Traits = VectorTraits<V>;
-		V res;
-		Traits::setElem(res, 0, Traits::getElem(lhs, 1) * Traits::getElem(rhs, 2) - Traits::getElem(lhs, 2) * Traits::getElem(rhs, 1));
-		Traits::setElem(res, 1, Traits::getElem(lhs, 2) * Traits::getElem(rhs, 0) - Traits::getElem(lhs, 0) * Traits::getElem(rhs, 2));
-		Traits::setElem(res, 2, Traits::getElem(lhs, 0) * Traits::getElem(rhs, 1) - Traits::getElem(lhs, 1) * Traits::getElem(rhs, 0));
-		return res;
-	}
-
-	template <Vector V>
-	constexpr auto normalize(V& v) {
-		auto len = length(v);
-		for (auto index = 0; index < VectorTraits<V>::dimension; ++index) {
-			VectorTraits<V>::setElem(v, index, VectorTraits<V>::getElem(v, index) / len);
-		}
-	}
-
-	template <Vector VecA, Vector VecB>
-	constexpr auto& operator+=(VecA& a, const VecB& b)
-		requires (VectorTraits<VecA>::dimension == VectorTraits<VecB>::dimension)
-	{
-		for (auto index = 0; index < VectorTraits<VecA>::dimension; ++index) {
-			VectorTraits<VecA>::setElem(a, index, VectorTraits<VecA>::getElem(a, index) + VectorTraits<VecB>::getElem(b, index));
-		}
-		return a;
-	}
-
-	template <Matrix MatA, Matrix MatB>
-		requires (MatrixTraits<MatA>::dimensionX == MatrixTraits<MatB>::dimensionY)
-	constexpr auto operator*(const MatA& a, const MatB& b) {
-		using ATr = MatrixTraits<MatA>;
-		using BTr = MatrixTraits<MatB>;
-		using MultiplyResult = decltype(ATr::getElem(a, 0, 0) * BTr::getElem(b, 0, 0));
-		using AdditionResult = decltype(std::declval<MultiplyResult>() + std::declval<MultiplyResult>());
-		constexpr auto bWidth = BTr::dimensionX;
-		constexpr auto aHeight = ATr::dimensionY;
-		constexpr auto depth = ATr::dimensionX;
-
-		auto result = Mat<AdditionResult, bWidth, aHeight>{};
-		using RTr = MatrixTraits<decltype(result)>;
-
-		for (int index = 0; index < bWidth * aHeight; ++index) {
-			int cellX = index % bWidth;
-			int cellY = index / bWidth;
-			auto sum = AdditionResult(0);
-			for (int i = 0; i < depth; ++i) {
-				sum += ATr::getElem(a, i, cellY) * BTr::getElem(b, cellX, i);
-			}
-			RTr::setElem(result, cellX, cellY, sum);
-		}
-		return result;
-	}
-
-	template <Matrix M>
-		requires (MatrixTraits<M>::dimensionX == 1)
-	auto toVector(const M& mat) {
-		using MTr = MatrixTraits<M>;
-		using Res = Vec<typename MTr::Elem, MTr::dimensionY>;
-		using RTr = VectorTraits<Res>;
-
-		Res res;
-		for (auto i = 0; i < MTr::dimensionY; ++i) {
-			RTr::setElem(res, i, MTr::getElem(mat, 0, i));
-		}
-		return res;
-	}
-
-	template <Vector V>
-	auto toMatrixColumn(const V& vec) {
-		using VTr = VectorTraits<V>;
-		using Res = Mat<typename VTr::Elem, 1, VTr::dimension>;
-		using RTr = MatrixTraits<Res>;
-
-		Res res;
-		for (auto i = 0; i < VTr::dimension; ++i) {
-			RTr::setElem(res, 0, i, VTr::getElem(vec, i));
-		}
-		return res;
-	}
-
-	template <Matrix M, Vector V>
-		requires (MatrixTraits<M>::dimensionX == VectorTraits<V>::dimension)
-	constexpr auto operator*(const M& a, const V& b) {
-		return toVector(a * toMatrixColumn(b));
-	}
-}
-
 // Examples of how to make custom builders, in case SimpleBuilders aren't enough
 
 struct VecBuilder {
@@ -328,7 +95,8 @@ void doVectorMatrixTest(lua_State* ls) {
 
 	// We specify a builder type for each 'parameter kind' used in the library, representing the set of types it can stand for
 	using floatB = lst::SimpleBuilder<float>;
-	using vecB = lst::SimpleBuilder<VecMat::Vec<float, 2>, VecMat::Vec<float, 3>, VecMat::Vec<float, 4>>;
+	using vecB = lst::SimpleExclusiveBuilder<VecMat::Vec<float, 2>, VecMat::Vec<float, 3>, VecMat::Vec<float, 4>>;
+	// ^ we mark this builder exclusive, since vectors of different lengths never match the same lua datum
 	using matB = lst::SimpleAmbiguousBuilder<
 		VecMat::Mat<float, 2, 2>, VecMat::Mat<float, 2, 3>, VecMat::Mat<float, 2, 4>,
 		VecMat::Mat<float, 3, 2>, VecMat::Mat<float, 3, 3>, VecMat::Mat<float, 3, 4>,
@@ -350,6 +118,10 @@ void doVectorMatrixTest(lua_State* ls) {
 	lst::pushBulkFunc<vecB, vecB>(ls, lstrapFuncWrapper(VecMat::cross));
 	lua_setglobal(ls, "cross");
 
+	// Both types accept lua numbers, so which one an arg is read as depends on its value (and never on the calls made before)
+	lst::pushBulkFunc<lst::SimpleBuilder<int, float>>(ls, [](auto x) { return std::string{ std::same_as<decltype(x), int> ? "int" : "float" }; });
+	lua_setglobal(ls, "numberKind");
+
 	lst::pushBulkFunc<vecB>(ls, lstrapFuncWrapper(VecMat::normalize));
 	lua_setglobal(ls, "normalize");
 
@@ -362,6 +134,46 @@ void doVectorMatrixTest(lua_State* ls) {
 	lst::pushBulkFunc<matB, matB>(ls, lstrapFuncWrapper(VecMat::operator*));
 	lua_setglobal(ls, "matMatMul");
 
+	// There's no limit on the number of parameters
+	lst::pushBulkFunc<vecB, floatB, floatB, floatB, floatB, floatB, floatB, floatB, floatB, floatB, floatB>(ls,
+		[](auto& v, float a, float b, float c, float d, float e, float f, float g, float h, float i, float j) {
+			return VecMat::length(v) + a + b + c + d + e + f + g + h + i + j;
+		});
+	lua_setglobal(ls, "lengthPlusTen");
+
+	// The "map" variant takes arrays of arguments, and returns the array of results
+	lst::pushBulkMapFunc<vecB, vecB>(ls, lstrapFuncWrapper(VecMat::dot));
+	lua_setglobal(ls, "dotEach");
+
+	// ShapeBuilders only attempt the types whose shape (here: the array length, as declared by the traits) matches the lua value
+	using vecShapeB = lst::ShapeBuilder<VecMat::Vec<float, 2>, VecMat::Vec<float, 3>, VecMat::Vec<float, 4>>;
+	using matShapeB = lst::ShapeAmbiguousBuilder<
+		VecMat::Mat<float, 2, 2>, VecMat::Mat<float, 2, 3>, VecMat::Mat<float, 2, 4>,
+		VecMat::Mat<float, 3, 2>, VecMat::Mat<float, 3, 3>, VecMat::Mat<float, 3, 4>,
+		VecMat::Mat<float, 4, 2>, VecMat::Mat<float, 4, 3>, VecMat::Mat<float, 4, 4>
+	>;
+	lst::pushBulkFunc<matShapeB, vecShapeB>(ls, lstrapFuncWrapper(VecMat::operator*));
+	lua_setglobal(ls, "matVecMulShaped");
+
+	// With flat dispatch, only the valid combinations of argument types are compiled into code paths
+	lst::pushBulkFunc<matB, matB>(ls, lst::flatDispatch(lstrapFuncWrapper(VecMat::operator*)));
+	lua_setglobal(ls, "matMatMulFlat");
+	lst::pushBulkFunc<matShapeB, vecShapeB>(ls, lst::flatDispatch(lstrapFuncWrapper(VecMat::operator*)));
+	lua_setglobal(ls, "matVecMulFlat");
+
+	// Alternatively, the functions can be described at compile time and published together
+	static constexpr auto vecLib = lst::Library{
+		lst::bulkFunc<vecB>("length", lstrapFuncWrapper(VecMat::length)),
+		lst::bulkFunc<vecB, vecB>("cross", lstrapFuncWrapper(VecMat::cross))
+	};
+	lst::pushLibrary(ls, vecLib);
+	lua_setglobal(ls, "vec");
+
+	// For 'markedForBaking' and 'unbaked'
+	lua_geti(ls, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	lst::publishLuaStrapUtils(ls);
+	lua_pop(ls, 1);
+
 	auto testFailed = luaL_dostring(ls, R"delim(
 
 	assert(dot({0, 1, 0, 1}, {1.0, 0.75, 0.5, 0.25}) == 1.0)
@@ -369,6 +181,10 @@ void doVectorMatrixTest(lua_State* ls) {
 
 	local cr = cross({1, 0, 0}, {0, 1, 0})
 	assert(cr[1] == 0 and cr[2] == 0 and cr[3] == 1)
+	local cr2 = vec.cross({1, 0, 0}, {0, 1, 0})
+	assert(cr2[1] == 0 and cr2[2] == 0 and cr2[3] == 1 and vec.length({3, 4}) == 5)
+
+	assert(lengthPlusTen({3, 4}, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10) == 60)
 
 	local sum = {1, 2}
 	vecMutAdd(sum, {2, 3})	
@@ -397,6 +213,15 @@ void doVectorMatrixTest(lua_State* ls) {
 	local newV = matVecMul(m, v)
 	assert(newV[1] == 2 and newV[2] == 9)
 
+	-- repeated argument shapes attempt the types they were read as last time, which mustn't change the outcome
+	assert(matVecMul(m, { 2, 3 })[3] == 5 and matVecMul(m, { 2, 3, 4 })[2] == 9 and matVecMul(m, { 2, 3 })[3] == 5 and matVecMul(m, { 2, 3, 4 })[2] == 9)
+	assert(dot({1, 2}, {3, 4}) == 11 and dot({1, 2, 3}, {1, 1, 1}) == 6 and dot({1, 2}, {3, 4}) == 11 and dot({1, 2, 3}, {1, 1, 1}) == 6)
+	assert(numberKind(1) == "int" and numberKind(1.5) == "float" and numberKind(2) == "int" and numberKind(2.5) == "float" and numberKind(3) == "int")
+	assert(matVecMulShaped(m, { 2, 3 })[3] == 5 and matVecMulShaped(m, { 2, 3, 4 })[2] == 9)
+	assert(not pcall(matVecMulShaped, m, { 2, 3, 4, 5 }) and not pcall(matVecMulShaped, m, { 2, "x" }))
+	assert(matVecMulFlat(m, { 2, 3 })[3] == 5 and matVecMulFlat(m, { 2, 3, 4 })[2] == 9)
+	assert(not pcall(matVecMulFlat, m, { 2, 3, 4, 5 }))
+
 	local mat = {
 		3, 5, 7,
 		7, 5, 3,
@@ -409,6 +234,25 @@ void doVectorMatrixTest(lua_State* ls) {
 	}
 
 	local doubledMat = matMatMul(scaleMat, mat)
+	local doubledMatFlat = matMatMulFlat(scaleMat, mat)
+	for i = 1, 9 do
+		assert(doubledMatFlat[i] == doubledMat[i])
+	end
+
+	-- Baked data is passed to bulk functions in place, without being copied
+	local dots = dotEach({ {1, 0}, {1, 2, 3}, {0, 1} }, { {2, 0}, {1, 1, 1}, markedForBaking({0, 3}) })
+	assert(#dots == 3 and dots[1] == 2 and dots[2] == 6 and dots[3] == 3)
+	assert(not pcall(dotEach, { {1, 0} }, {}) and not pcall(dotEach, { {1, 0} }, { {1, 2, 3} }))
+
+	local bakedScaleMat = markedForBaking(scaleMat)
+	for i = 1, 3 do
+		assert(matMatMul(bakedScaleMat, mat)[1] == 6)
+	end
+	local bakedSum = markedForBaking({1, 2})
+	vecMutAdd(bakedSum, {2, 3})
+	vecMutAdd(bakedSum, {2, 3})
+	bakedSum = unbaked(bakedSum)
+	assert(bakedSum[1] == 5 and bakedSum[2] == 8)
 
 	-- Two possible interpretations; either mat1 is 2x3 and mat2 is 3x2, or the other way around.
 	-- Which one wins is deterministic, but not immediately obvious. Avoid this.